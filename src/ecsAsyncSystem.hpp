@@ -0,0 +1,384 @@
+#pragma once
+#ifndef MINIECS_ECSASYNCSYSTEM_HPP
+#define MINIECS_ECSASYNCSYSTEM_HPP
+
+#if !defined(__cpp_impl_coroutine)
+#error "ecsAsyncSystem.hpp requires C++20 coroutines, configure with MINIECS_COROUTINES"
+#endif
+
+#include "ecsSystem.hpp"
+#include "ecsWorld.hpp"
+#include <algorithm>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace mini {
+///////////////////////////////////////////////////////////////////////////
+/// Forward Declarations
+class ecsAsyncContext;
+class ecsAsyncScheduler;
+
+///////////////////////////////////////////////////////////////////////////
+/// \class  ecsAsyncTask
+/// \brief  One run of an async system, a coroutine resumed by its scheduler.
+/// \note   Runs may co_await a std::future, resuming once its job is ready, or
+///         the context's nextTick(), resuming on the next update. Nothing else
+///         may be awaited, as only the scheduler may resume a run.
+class ecsAsyncTask final {
+    public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  The coroutine state of a run.
+    struct promise_type {
+        ///////////////////////////////////////////////////////////////////////////
+        /// \brief  Awaits a job's future from within a run.
+        template <typename Result> struct JobAwaiter {
+            ///////////////////////////////////////////////////////////////////////////
+            /// \brief  Check if the job finished, so the run needn't suspend.
+            /// \return	true if the future is ready, false otherwise.
+            [[nodiscard]] bool await_ready() const {
+                return m_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            }
+            ///////////////////////////////////////////////////////////////////////////
+            /// \brief  Suspend the run until the job finishes.
+            /// \param	handle				the suspended run.
+            void await_suspend(const std::coroutine_handle<promise_type> handle) {
+                handle.promise().m_ready = [this] { return await_ready(); };
+            }
+            ///////////////////////////////////////////////////////////////////////////
+            /// \brief  Retrieve the job's result.
+            /// \return	the result of the job.
+            Result await_resume() { return m_future.get(); }
+
+            std::future<Result> m_future; ///< The job's result.
+        };
+        ///////////////////////////////////////////////////////////////////////////
+        /// \brief  Awaits a later update from within a run.
+        struct TickAwaiter {
+            ///////////////////////////////////////////////////////////////////////////
+            /// \brief  Runs always suspend, the update they wait for is still ahead.
+            /// \return	false.
+            [[nodiscard]] bool await_ready() const noexcept { return false; }
+            ///////////////////////////////////////////////////////////////////////////
+            /// \brief  Suspend the run until the update it waits for.
+            /// \param	handle				the suspended run.
+            void await_suspend(const std::coroutine_handle<promise_type> handle) {
+                handle.promise().m_ready = [this] { return *m_tick >= m_resumeTick; };
+            }
+            ///////////////////////////////////////////////////////////////////////////
+            /// \brief  Resume the run, there's no result.
+            void await_resume() const noexcept {}
+
+            const uint64_t* m_tick = nullptr; ///< The scheduler's update count.
+            uint64_t m_resumeTick = 0ULL;     ///< The update to resume in.
+        };
+
+        ///////////////////////////////////////////////////////////////////////////
+        /// \brief  Retrieve the task owning this run.
+        /// \return	the run's task.
+        ecsAsyncTask get_return_object() noexcept {
+            return ecsAsyncTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        ///////////////////////////////////////////////////////////////////////////
+        /// \brief  Runs start suspended, their scheduler resumes them first.
+        /// \return	an awaitable always suspending.
+        [[nodiscard]] std::suspend_always initial_suspend() const noexcept { return {}; }
+        ///////////////////////////////////////////////////////////////////////////
+        /// \brief  Runs stay suspended once finished, their task destroys them.
+        /// \return	an awaitable always suspending.
+        [[nodiscard]] std::suspend_always final_suspend() const noexcept { return {}; }
+        ///////////////////////////////////////////////////////////////////////////
+        /// \brief  Finish a run, there's no result.
+        void return_void() const noexcept {}
+        ///////////////////////////////////////////////////////////////////////////
+        /// \brief  Runs may not throw, an escaping exception terminates.
+        void unhandled_exception() const noexcept { std::terminate(); }
+        ///////////////////////////////////////////////////////////////////////////
+        /// \brief  Await a job, taking its future.
+        /// \param	future				the job's future.
+        /// \return	an awaitable resuming once the job finishes.
+        template <typename Result> JobAwaiter<Result> await_transform(std::future<Result>&& future) noexcept {
+            return JobAwaiter<Result>{ std::move(future) };
+        }
+        ///////////////////////////////////////////////////////////////////////////
+        /// \brief  Await a job, taking its future.
+        /// \param	future				the job's future, left invalid.
+        /// \return	an awaitable resuming once the job finishes.
+        template <typename Result> JobAwaiter<Result> await_transform(std::future<Result>& future) noexcept {
+            return JobAwaiter<Result>{ std::move(future) };
+        }
+        ///////////////////////////////////////////////////////////////////////////
+        /// \brief  Await a later update.
+        /// \param	awaiter				the update to wait for.
+        /// \return	the same awaiter.
+        [[nodiscard]] TickAwaiter await_transform(const TickAwaiter awaiter) const noexcept { return awaiter; }
+
+        std::function<bool()> m_ready; ///< Checks if the awaited work finished, empty if runnable.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Destroy this task, along with its coroutine if unfinished.
+    ~ecsAsyncTask() { reset(); }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Construct an empty task.
+    ecsAsyncTask() noexcept = default;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Move a task.
+    /// \param	other				the task to move from, left empty.
+    ecsAsyncTask(ecsAsyncTask&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Move-assign a task, destroying this one's coroutine first.
+    /// \param	other				the task to move from, left empty.
+    /// \return	reference to this.
+    ecsAsyncTask& operator=(ecsAsyncTask&& other) noexcept {
+        if (this != &other) {
+            reset();
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Check if this task has no run in progress.
+    /// \return	true if empty or finished, false if suspended.
+    [[nodiscard]] bool isDone() const noexcept { return !m_handle || m_handle.done(); }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Check if this task's run can be resumed.
+    /// \return	true if suspended and its awaited work finished, false otherwise.
+    [[nodiscard]] bool isReady() const {
+        return !isDone() && (!m_handle.promise().m_ready || m_handle.promise().m_ready());
+    }
+
+    private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Construct a task owning a coroutine.
+    /// \param	handle				the coroutine to own.
+    explicit ecsAsyncTask(const std::coroutine_handle<promise_type> handle) noexcept : m_handle(handle) {}
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Resume this task's run until its next wait or its end.
+    void resume() {
+        m_handle.promise().m_ready = nullptr;
+        m_handle.resume();
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Destroy this task's coroutine, if any.
+    void reset() noexcept {
+        if (m_handle) {
+            m_handle.destroy();
+            m_handle = nullptr;
+        }
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Disallow copying a task.
+    ecsAsyncTask(const ecsAsyncTask&) = delete;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Disallow task copy assignment.
+    ecsAsyncTask& operator=(const ecsAsyncTask&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    std::coroutine_handle<promise_type> m_handle = nullptr; ///< The run's coroutine, if any.
+    friend class ecsAsyncScheduler;                         ///< Allows the scheduler to resume runs.
+};
+
+///////////////////////////////////////////////////////////////////////////
+/// \class  ecsAsyncContext
+/// \brief  What a scheduler offers the runs of its async systems.
+class ecsAsyncContext final {
+    public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the world the runs operate on.
+    /// \note   Component pointers don't survive a wait, as other systems and
+    ///         edits may move components meanwhile. Use a ComponentRef instead.
+    /// \return	the scheduler's world.
+    [[nodiscard]] ecsWorld& getWorld() const noexcept { return m_world; }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the delta time of the update a run was resumed in.
+    /// \return	the current update's delta time.
+    [[nodiscard]] double getDeltaTime() const noexcept { return m_deltaTime; }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve something for a run to co_await until the next update.
+    /// \return	an awaitable resuming on the next update.
+    [[nodiscard]] ecsAsyncTask::promise_type::TickAwaiter nextTick() const noexcept {
+        return { &m_tick, m_tick + 1ULL };
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Defer a structural edit to the end of the current update.
+    /// \note   Edits apply in order, after every system ran, so no system sees
+    ///         the world change shape in the middle of an update.
+    /// \param	edit				function making the edit.
+    void defer(std::function<void(ecsWorld&)> edit) { m_edits.emplace_back(std::move(edit)); }
+
+    private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Construct a context for a world.
+    /// \param	world				the world the runs operate on.
+    explicit ecsAsyncContext(ecsWorld& world) noexcept : m_world(world) {}
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    ecsWorld& m_world;                                   ///< The world the runs operate on.
+    double m_deltaTime = 0.0;                            ///< The current update's delta time.
+    uint64_t m_tick = 0ULL;                              ///< Number of updates so far.
+    std::vector<std::function<void(ecsWorld&)>> m_edits; ///< Edits deferred to the end of the update.
+    friend class ecsAsyncScheduler;                      ///< Allows the scheduler to advance the context.
+};
+
+///////////////////////////////////////////////////////////////////////////
+/// \class  ecsAsyncSystem
+/// \brief  An interface for systems waiting on async work, such as jobs or
+///         streaming, without blocking the systems updated alongside them.
+class ecsAsyncSystem {
+    public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Virtual async system destructor.
+    virtual ~ecsAsyncSystem() = default;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Construct an async system.
+    ecsAsyncSystem() = default;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Start a run of this system.
+    /// \note   Called on each update this system has no run in progress, so a
+    ///         run spanning several updates isn't started again meanwhile.
+    /// \param	context				the scheduler's context, valid for the whole run.
+    /// \return	the run's coroutine.
+    virtual ecsAsyncTask run(ecsAsyncContext& context) = 0;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Check if a run of this system is suspended.
+    /// \return	true if a run is in progress, false otherwise.
+    [[nodiscard]] bool isRunning() const noexcept { return !m_task.isDone(); }
+
+    private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Disallow copying an async system.
+    ecsAsyncSystem(const ecsAsyncSystem&) = delete;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Disallow async system copy assignment.
+    ecsAsyncSystem& operator=(const ecsAsyncSystem&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    ecsAsyncTask m_task;            ///< The run in progress, if any.
+    friend class ecsAsyncScheduler; ///< Allows the scheduler to start runs.
+};
+
+///////////////////////////////////////////////////////////////////////////
+/// \class  ecsAsyncScheduler
+/// \brief  Updates a world's systems, interleaving async systems with them.
+/// \note   Runs resume on the updating thread, between systems, once their
+///         awaited work finishes. Deferred edits apply at the end of each
+///         update, which is the sync point, before observers are flushed.
+class ecsAsyncScheduler final {
+    public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Destroy this scheduler, abandoning runs in progress.
+    /// \note   Abandoned runs destroy their awaited futures, which may block.
+    ~ecsAsyncScheduler() {
+        for (auto& system : m_systems) {
+            system->m_task.reset();
+        }
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Construct a scheduler for a world.
+    /// \param	world				the world to update.
+    explicit ecsAsyncScheduler(ecsWorld& world) noexcept : m_context(world) {}
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Add an async system to the scheduler.
+    /// \param	system				the system to add.
+    /// \return	true if successfully added, false if null or present.
+    bool addSystem(const std::shared_ptr<ecsAsyncSystem>& system) {
+        if (!system || std::find(m_systems.cbegin(), m_systems.cend(), system) != m_systems.cend()) {
+            return false;
+        }
+        m_systems.emplace_back(system);
+        return true;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Remove an async system, abandoning its run in progress.
+    /// \param	system				the system to remove.
+    /// \return	true if successfully removed, false otherwise.
+    bool removeSystem(const ecsAsyncSystem& system) {
+        const auto position = std::find_if(
+            m_systems.begin(), m_systems.end(), [&](const auto& candidate) { return candidate.get() == &system; });
+        if (position == m_systems.end()) {
+            return false;
+        }
+        (*position)->m_task.reset();
+        m_systems.erase(position);
+        return true;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the number of async systems with a run in progress.
+    /// \return	the number of suspended runs.
+    [[nodiscard]] size_t getRunningCount() const noexcept {
+        return static_cast<size_t>(std::count_if(
+            m_systems.cbegin(), m_systems.cend(), [](const auto& system) { return system->isRunning(); }));
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Update the world's systems, then apply deferred edits.
+    /// \param	systems				the synchronous systems to update, in order.
+    /// \param	deltaTime			the delta time.
+    void updateSystems(ecsSystemList& systems, const double deltaTime) {
+        m_context.m_deltaTime = deltaTime;
+        ++m_context.m_tick;
+        for (auto& system : m_systems) {
+            if (system->m_task.isDone()) {
+                system->m_task = system->run(m_context);
+            }
+        }
+
+        // Runs resume whenever their work finishes, in between other systems
+        resumeReady();
+        for (auto& system : systems) {
+            m_context.m_world.updateSystem(*system, deltaTime);
+            resumeReady();
+        }
+
+        // Edits may be deferred again while applying, those wait for the next update
+        auto edits = std::move(m_context.m_edits);
+        m_context.m_edits.clear();
+        for (auto& edit : edits) {
+            edit(m_context.m_world);
+        }
+        m_context.m_world.flushObservers();
+    }
+
+    private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Resume every run whose awaited work finished, until none is ready.
+    void resumeReady() {
+        bool resumed(true);
+        while (resumed) {
+            resumed = false;
+            for (auto& system : m_systems) {
+                if (system->m_task.isReady()) {
+                    system->m_task.resume();
+                    resumed = true;
+                }
+            }
+        }
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Disallow copying a scheduler.
+    ecsAsyncScheduler(const ecsAsyncScheduler&) = delete;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Disallow scheduler copy assignment.
+    ecsAsyncScheduler& operator=(const ecsAsyncScheduler&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    ecsAsyncContext m_context;                              ///< Offered to every run.
+    std::vector<std::shared_ptr<ecsAsyncSystem>> m_systems; ///< Async systems, in start order.
+};
+};     // namespace mini
+#endif // MINIECS_ECSASYNCSYSTEM_HPP
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "ecsColdStore.hpp"
+#include <cstdio>
+
+///////////////////////////////////////////////////////////////////////////
+/// Use our shared namespace mini
+using namespace mini;
+
+///////////////////////////////////////////////////////////////////////////
+/// ~ecsColdStore
+///////////////////////////////////////////////////////////////////////////
+
+ecsColdStore::~ecsColdStore() {
+    if (m_file.is_open()) {
+        m_file.close();
+        std::remove(m_path.c_str());
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// ecsColdStore
+///////////////////////////////////////////////////////////////////////////
+
+ecsColdStore::ecsColdStore(std::string path)
+    : m_path(std::move(path)),
+      m_file(m_path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc) {}
+
+///////////////////////////////////////////////////////////////////////////
+/// append
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsColdStore::append(const std::vector<std::pair<EntityHandle, size_t>>& records, const ComponentDataSpace& data) {
+    if (!m_file.is_open() || data.empty()) {
+        return data.empty();
+    }
+
+    m_file.seekp(m_fileSize);
+    if (!m_file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()))) {
+        m_file.clear();
+        return false;
+    }
+
+    // Newer records replace older ones for the same entity
+    for (const auto& [entityHandle, size] : records) {
+        m_records.insert_or_assign(entityHandle, std::make_pair(m_fileSize, size));
+        m_fileSize += static_cast<std::streamoff>(size);
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// read
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsColdStore::read(const EntityHandle& entityHandle, ComponentDataSpace& data) {
+    const auto record = m_records.find(entityHandle);
+    if (record == m_records.end()) {
+        return false;
+    }
+
+    const auto& [offset, size] = record->second;
+    data.resize(size);
+    m_file.seekg(offset);
+    if (!m_file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(size))) {
+        m_file.clear();
+        return false;
+    }
+    return true;
+}
\ No newline at end of file
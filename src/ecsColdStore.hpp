@@ -0,0 +1,80 @@
+#pragma once
+#ifndef MINIECS_ECSCOLDSTORE_HPP
+#define MINIECS_ECSCOLDSTORE_HPP
+
+#include "ecsComponent.hpp"
+#include "ecsHandle.hpp"
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mini {
+///////////////////////////////////////////////////////////////////////////
+/// \class  ecsColdStore
+/// \brief  A disk-backed store holding entities evicted from an ecsWorld.
+/// \note   Records are flat byte images written back to back, so the file can
+///         be memory mapped. Images reference this process's component
+///         registry, so a store only lives as long as the process does.
+class ecsColdStore final {
+    public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Destroy this store, deleting its file.
+    ~ecsColdStore();
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Construct a store, creating or truncating its file.
+    /// \param	path				the file to hold evicted entities.
+    explicit ecsColdStore(std::string path);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Check if the store's file could be opened.
+    /// \return	true if the store is usable, false otherwise.
+    [[nodiscard]] bool isOpen() const { return m_file.is_open(); }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Check if an entity is held in this store.
+    /// \param	entityHandle		handle to the entity to check.
+    /// \return	true if the entity is held, false otherwise.
+    [[nodiscard]] bool contains(const EntityHandle& entityHandle) const {
+        return m_records.find(entityHandle) != m_records.cend();
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the number of entities held.
+    /// \return	the number of entities held.
+    [[nodiscard]] size_t size() const noexcept { return m_records.size(); }
+
+    private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Disallow copying a store.
+    ecsColdStore(const ecsColdStore&) = delete;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Disallow store copy assignment.
+    ecsColdStore& operator=(const ecsColdStore&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Append a batch of records in a single write.
+    /// \param	records				each record's entity and byte-size, in order.
+    /// \param	data				the records' bytes, back to back.
+    /// \return	true on success, false otherwise.
+    bool append(const std::vector<std::pair<EntityHandle, size_t>>& records, const ComponentDataSpace& data);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Read an entity's record back.
+    /// \param	entityHandle		handle to the entity to read.
+    /// \param	data				the buffer to fill with the record's bytes.
+    /// \return	true on success, false otherwise.
+    bool read(const EntityHandle& entityHandle, ComponentDataSpace& data);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Forget an entity's record, its bytes are left in the file.
+    /// \param	entityHandle		handle to the entity to forget.
+    void erase(const EntityHandle& entityHandle) { m_records.erase(entityHandle); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    std::string m_path;                                                  ///< The file's path.
+    std::fstream m_file;                                                 ///< The file holding records.
+    std::streamoff m_fileSize = 0;                                       ///< Bytes written to the file.
+    std::map<EntityHandle, std::pair<std::streamoff, size_t>> m_records; ///< Offset and size of each record.
+    friend class ecsWorld;                                               ///< Allows the ecsWorld to evict and restore.
+};
+};     // namespace mini
+#endif // MINIECS_ECSCOLDSTORE_HPP
\ No newline at end of file
@@ -9,9 +9,10 @@ using namespace mini;
 ///////////////////////////////////////////////////////////////////////////
 
 ComponentID ecsBaseComponent::registerType(
-    const ComponentCreateFunction& createFn, const ComponentFreeFunction& freeFn, const size_t& size) {
+    const ComponentCreateFunction createFn, const ComponentFreeFunction freeFn, const size_t& size,
+    const bool trivialCopy, const ecsStoragePolicy storage) {
     auto componentID = static_cast<ComponentID>(m_componentRegistry.size());
-    m_componentRegistry.emplace_back(createFn, freeFn, size);
+    m_componentRegistry.emplace_back(createFn, freeFn, size, trivialCopy, storage);
 
     return componentID;
 }
\ No newline at end of file
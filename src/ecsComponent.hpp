@@ -3,10 +3,14 @@
 #define MINIECS_ECSCOMPONENT_HPP
 
 #include "ecsHandle.hpp"
-#include <functional>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <map>
 #include <memory>
+#include <stdexcept>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 
 namespace mini {
@@ -17,11 +21,49 @@ class ecsBaseComponent;
 ///////////////////////////////////////////////////////////////////////////
 /// Useful Aliases.
 using ComponentID = int;
+/// Rows within a pool, 64-bit only for worlds whose pools outgrow 32-bit rows.
+#ifdef MINIECS_64BIT_INDICES
+using ComponentIndex = uint64_t;
+#else
+using ComponentIndex = uint32_t;
+#endif
 using ComponentDataSpace = std::vector<uint8_t>;
-using ComponentCreateFunction = std::function<ComponentID(
+using ComponentCreateFunction = ComponentIndex (*)(
     ComponentDataSpace& memory, const ComponentHandle& componentHandle, const EntityHandle& entityHandle,
-    const ecsBaseComponent*)>;
-using ComponentFreeFunction = std::function<void(ecsBaseComponent* comp)>;
+    const ecsBaseComponent*);
+using ComponentFreeFunction = void (*)(ecsBaseComponent* comp);
+
+///////////////////////////////////////////////////////////////////////////
+/// \brief  How a world stores the components of a class.
+enum class ecsStoragePolicy {
+    DENSE,  ///< One contiguous pool, swap-removed, best for common components.
+    PAGED,  ///< Fixed pages that never move, removals leave holes to reuse.
+    SPARSE, ///< One allocation per component, best for rare and large ones.
+};
+
+///////////////////////////////////////////////////////////////////////////
+/// \class  ecsComponentTraits
+/// \brief  Describes how a component class may be copied, destroyed and stored.
+/// \note   Components have a virtual table, so the standard traits are false
+///         for every component. Specialize this for components whose members
+///         are all trivial, letting bulk operations skip per-component calls.
+///         Specializations may also name a Storage policy, dense by default.
+/// \tparam	C   the type of component.
+template <typename C> struct ecsComponentTraits {
+    static constexpr bool TriviallyCopyable = std::is_trivially_copyable_v<C>;         ///< Copyable with memcpy.
+    static constexpr bool TriviallyDestructible = std::is_trivially_destructible_v<C>; ///< Destruction is a no-op.
+    static constexpr ecsStoragePolicy Storage = ecsStoragePolicy::DENSE;               ///< How worlds store it.
+};
+
+///////////////////////////////////////////////////////////////////////////
+/// \class  ecsTrivialComponentTraits
+/// \brief  Traits of a component whose members are all trivial, for use as
+///         the base of an ecsComponentTraits specialization.
+struct ecsTrivialComponentTraits {
+    static constexpr bool TriviallyCopyable = true;                      ///< Copyable with memcpy.
+    static constexpr bool TriviallyDestructible = true;                  ///< Destruction is a no-op.
+    static constexpr ecsStoragePolicy Storage = ecsStoragePolicy::DENSE; ///< How worlds store it.
+};
 
 ///////////////////////////////////////////////////////////////////////////
 /// \class  ecsBaseComponent
@@ -55,10 +97,12 @@ class ecsBaseComponent {
 
     ///////////////////////////////////////////////////////////////////////////
     /// Public Attributes
-    ComponentID m_runtimeID = 0; ///< Runtime generated ID per class.
-    size_t m_size = 0;           ///< Total component byte-size.
-    ComponentHandle m_handle;    ///< This component's UUID.
-    EntityHandle m_entityHandle; ///< This component's parents' UUID (entity).
+    ComponentID m_runtimeID = 0;   ///< Runtime generated ID per class.
+    size_t m_size = 0;             ///< Total component byte-size.
+    ComponentHandle m_handle;      ///< This component's UUID.
+    EntityHandle m_entityHandle;   ///< This component's parents' UUID (entity).
+    uint64_t m_changedTick = 0ULL; ///< World tick of the last marked write.
+    uint64_t m_addedTick = 0ULL;   ///< World tick the component was added at.
 
     protected:
     ///////////////////////////////////////////////////////////////////////////
@@ -66,15 +110,25 @@ class ecsBaseComponent {
     /// \param	createFn    function for creating a specific component type.
     /// \param	freeFn		function for freeing a specific component type.
     /// \param	size		the total size of a single component.
+    /// \param	trivialCopy	true if components may be copied with memcpy.
+    /// \param	storage		how worlds store components of this type.
     /// \return				runtime component ID.
-    static ComponentID
-    registerType(const ComponentCreateFunction& createFn, const ComponentFreeFunction& freeFn, const size_t& size);
+    /// \note   A null freeFn marks components which need no destruction.
+    static ComponentID registerType(
+        const ComponentCreateFunction createFn, const ComponentFreeFunction freeFn, const size_t& size,
+        const bool trivialCopy = false, const ecsStoragePolicy storage = ecsStoragePolicy::DENSE);
 
     ///////////////////////////////////////////////////////////////////////////
     /// Protected Attributes
-    inline static std::vector<std::tuple<ComponentCreateFunction, ComponentFreeFunction, size_t>>
-        m_componentRegistry = {}; ///< Container for component functions.
-    friend class ecsWorld;        ///< Allows the ecsWorld to access.
+    inline static std::vector<
+        std::tuple<ComponentCreateFunction, ComponentFreeFunction, size_t, bool, ecsStoragePolicy>>
+        m_componentRegistry = {};              ///< Container for component functions.
+    friend class ecsWorld;                     ///< Allows the ecsWorld to access.
+    friend class ecsSnapshot;                  ///< Allows snapshots to access.
+    friend class ecsSpawnBuffer;               ///< Allows spawn buffers to access.
+    friend class ecsTraceRecorder;             ///< Allows trace recorders to describe classes.
+    friend class ecsTraceReplayer;             ///< Allows trace replayers to register stand-ins.
+    template <typename T> friend class ecsTag; ///< Allows tags to register.
 };
 
 ///////////////////////////////////////////////////////////////////////////
@@ -92,26 +146,56 @@ template <typename C> class ecsComponent : public ecsBaseComponent {
     static const ComponentID Runtime_ID; ///< Runtime generated ID per class.
 };
 
+///////////////////////////////////////////////////////////////////////////
+/// \class  ecsTag
+/// \brief  A zero-size marker type, stored only as a bit in an entity's
+///         signature. Tags share the component ID space so they can be used
+///         in system queries, but never occupy component memory.
+/// \tparam	T   the type of this tag.
+template <typename T> class ecsTag {
+    public:
+    ///////////////////////////////////////////////////////////////////////////
+    // Public Static Type-Specific Attributes
+    static const ComponentID Runtime_ID; ///< Runtime generated ID per class.
+};
+
+///////////////////////////////////////////////////////////////////////////
+/// \brief  Narrows a pool row to a ComponentIndex, failing loudly rather than truncating.
+/// \note   Checked in every build, larger pools need MINIECS_64BIT_INDICES.
+/// \param	row     the row within a pool.
+/// \return			the row as a ComponentIndex.
+inline ComponentIndex toComponentIndex(const size_t row) {
+    if constexpr (sizeof(ComponentIndex) < sizeof(size_t)) {
+        if (row > std::numeric_limits<ComponentIndex>::max()) {
+            throw std::length_error("MiniECS: pool rows exceed ComponentIndex, build with MINIECS_64BIT_INDICES");
+        }
+    }
+    return static_cast<ComponentIndex>(row);
+}
+
 ///////////////////////////////////////////////////////////////////////////
 /// \brief Constructs a new component of type <C> into the memory space.
 /// \param	memory			raw data vector representing all <C> components.
 /// \param	componentHandle handle to the component.
 /// \param	entityHandle    handle to the component's parent entity.
-/// \return					the index into the memory array for this component.
+/// \return					the element index of this component in the memory array.
 template <typename ComponentTypeC>
-constexpr static int createFn(
+constexpr static ComponentIndex createFn(
     ComponentDataSpace& memory, const ComponentHandle& componentHandle, const EntityHandle& entityHandle,
-    const ecsBaseComponent* component) noexcept {
+    const ecsBaseComponent* component) {
     size_t index = memory.size();
+    const auto row = toComponentIndex(index / sizeof(ComponentTypeC));
     memory.resize(index + sizeof(ComponentTypeC));
     ComponentTypeC* clone = nullptr;
     if (component == nullptr)
         clone = new (&memory[index]) ComponentTypeC();
+    else if constexpr (ecsComponentTraits<ComponentTypeC>::TriviallyCopyable)
+        clone = static_cast<ComponentTypeC*>(std::memcpy(&memory[index], component, sizeof(ComponentTypeC)));
     else
         clone = new (&memory[index]) ComponentTypeC(*static_cast<const ComponentTypeC*>(component));
     clone->m_handle = componentHandle;
     clone->m_entityHandle = entityHandle;
-    return static_cast<int>(index);
+    return row;
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -122,8 +206,33 @@ template <typename ComponentType> constexpr static void freeFn(ecsBaseComponent*
     castComponent->~ComponentType();
 }
 
+///////////////////////////////////////////////////////////////////////////
+/// \brief  Detects traits naming a storage policy, older specializations don't.
+template <typename Traits, typename = void> struct ecsHasStoragePolicy : std::false_type {};
+template <typename Traits>
+struct ecsHasStoragePolicy<Traits, std::void_t<decltype(Traits::Storage)>> : std::true_type {};
+
+///////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieve the storage policy of a component class.
+/// \return	the policy named by its traits, dense if they name none.
+template <typename C> constexpr static ecsStoragePolicy storagePolicyOf() noexcept {
+    if constexpr (ecsHasStoragePolicy<ecsComponentTraits<C>>::value) {
+        return ecsComponentTraits<C>::Storage;
+    } else {
+        return ecsStoragePolicy::DENSE;
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////
 /// \brief  Generate a runtime static ID for each component class used.
-template <typename C> const ComponentID ecsComponent<C>::Runtime_ID(registerType(createFn<C>, freeFn<C>, sizeof(C)));
+template <typename C>
+const ComponentID ecsComponent<C>::Runtime_ID(registerType(
+    createFn<C>, ecsComponentTraits<C>::TriviallyDestructible ? nullptr : &freeFn<C>, sizeof(C),
+    ecsComponentTraits<C>::TriviallyCopyable, storagePolicyOf<C>()));
+
+///////////////////////////////////////////////////////////////////////////
+/// \brief  Generate a runtime static ID for each tag class used.
+template <typename T>
+const ComponentID ecsTag<T>::Runtime_ID(ecsBaseComponent::registerType(nullptr, nullptr, 0ULL));
 };     // namespace mini
 #endif // MINIECS_ECSCOMPONENT_HPP
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+#ifndef MINIECS_ECSCOMPONENTREF_HPP
+#define MINIECS_ECSCOMPONENTREF_HPP
+
+#include "ecsHandle.hpp"
+#include "ecsWorld.hpp"
+#include <cstdint>
+
+namespace mini {
+///////////////////////////////////////////////////////////////////////////
+/// \class  ComponentRef
+/// \brief  A reference to an entity's component, caching where it was last
+///         found for as long as nothing of its class has moved.
+/// \note   Resolving updates the cache, so each thread should hold its own
+///         references. Re-resolving is needed only after components of the
+///         class were added to a full pool, removed, swapped or compacted.
+/// \tparam	Component           the class type of component.
+template <typename Component> class ComponentRef final {
+    public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Construct a reference to nothing.
+    ComponentRef() = default;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Construct a reference to an entity's component.
+    /// \param	entityHandle		handle to the entity owning the component.
+    explicit ComponentRef(const EntityHandle& entityHandle) : m_entityHandle(entityHandle) {}
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the entity this reference targets.
+    /// \return	handle to the entity.
+    [[nodiscard]] const EntityHandle& getEntityHandle() const noexcept { return m_entityHandle; }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retarget this reference, discarding its cache.
+    /// \param	entityHandle		handle to the entity owning the component.
+    void reset(const EntityHandle& entityHandle = EntityHandle()) noexcept {
+        m_entityHandle = entityHandle;
+        m_world = nullptr;
+        m_component = nullptr;
+        m_version = 0ULL;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Find the component, from the cache while its version holds.
+    /// \param	world				the world holding the entity.
+    /// \return	the component on success, nullptr otherwise.
+    [[nodiscard]] Component* resolve(ecsWorld& world) {
+        if (m_world == &world && m_version == world.getStructuralVersion(Component::Runtime_ID)) {
+            return m_component;
+        }
+
+        // Only found components are cached, a missing one may be added without bumping the version
+        m_component = world.getComponent<Component>(m_entityHandle);
+        m_world = m_component == nullptr ? nullptr : &world;
+        m_version = m_component == nullptr ? 0ULL : world.getStructuralVersion(Component::Runtime_ID);
+        return m_component;
+    }
+
+    private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    EntityHandle m_entityHandle;       ///< The entity owning the component.
+    const ecsWorld* m_world = nullptr; ///< The world the cache belongs to.
+    Component* m_component = nullptr;  ///< The component found last.
+    uint64_t m_version = 0ULL;         ///< The class's structural version when found.
+};
+};     // namespace mini
+#endif // MINIECS_ECSCOMPONENTREF_HPP
\ No newline at end of file
@@ -8,13 +8,106 @@
 #include <vector>
 
 namespace mini {
+///////////////////////////////////////////////////////////////////////////
+/// \class  ecsSignature
+/// \brief  A bit-set of the component and tag types an entity owns.
+class ecsSignature final {
+    public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Set the bit for a specific component type.
+    /// \param	componentID     the component type to set.
+    void set(const ComponentID componentID) {
+        const auto word = static_cast<size_t>(componentID) / WordBits;
+        if (word >= m_bits.size()) {
+            m_bits.resize(word + 1ULL, 0ULL);
+        }
+        m_bits[word] |= 1ULL << (static_cast<size_t>(componentID) % WordBits);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Clear the bit for a specific component type.
+    /// \param	componentID     the component type to clear.
+    void reset(const ComponentID componentID) noexcept {
+        if (const auto word = static_cast<size_t>(componentID) / WordBits; word < m_bits.size()) {
+            m_bits[word] &= ~(1ULL << (static_cast<size_t>(componentID) % WordBits));
+        }
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Check the bit for a specific component type.
+    /// \param	componentID     the component type to check.
+    /// \return	true if the bit is set, false otherwise.
+    [[nodiscard]] bool test(const ComponentID componentID) const noexcept {
+        const auto word = static_cast<size_t>(componentID) / WordBits;
+        return word < m_bits.size() && ((m_bits[word] >> (static_cast<size_t>(componentID) % WordBits)) & 1ULL) != 0ULL;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Check if every bit of another signature is set in this one.
+    /// \param	other           the signature to compare against.
+    /// \return	true if this is a superset of the other, false otherwise.
+    [[nodiscard]] bool containsAll(const ecsSignature& other) const noexcept {
+        const auto wordCount = other.m_bits.size();
+        for (size_t i = 0; i < wordCount; ++i) {
+            const auto word = i < m_bits.size() ? m_bits[i] : 0ULL;
+            if ((word & other.m_bits[i]) != other.m_bits[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Check if any bit of another signature is set in this one.
+    /// \param	other           the signature to compare against.
+    /// \return	true if the signatures overlap, false otherwise.
+    [[nodiscard]] bool intersects(const ecsSignature& other) const noexcept {
+        const auto wordCount = std::min(m_bits.size(), other.m_bits.size());
+        for (size_t i = 0; i < wordCount; ++i) {
+            if ((m_bits[i] & other.m_bits[i]) != 0ULL) {
+                return true;
+            }
+        }
+        return false;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Compare if this should be ordered before another signature.
+    /// \note   Missing words count as zero, so cleared bits never affect order.
+    /// \param	other           the signature to compare against.
+    /// \return	true if this signature is less than the other signature.
+    [[nodiscard]] bool operator<(const ecsSignature& other) const noexcept {
+        for (auto i = std::max(m_bits.size(), other.m_bits.size()); i-- > 0ULL;) {
+            const auto word = i < m_bits.size() ? m_bits[i] : 0ULL;
+            const auto otherWord = i < other.m_bits.size() ? other.m_bits[i] : 0ULL;
+            if (word != otherWord) {
+                return word < otherWord;
+            }
+        }
+        return false;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Check if no bits are set.
+    /// \return	true if the signature is empty, false otherwise.
+    [[nodiscard]] bool empty() const noexcept {
+        return std::all_of(m_bits.cbegin(), m_bits.cend(), [](const auto& word) { return word == 0ULL; });
+    }
+
+    private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    static constexpr size_t WordBits = 64ULL; ///< Number of bits per word.
+    std::vector<uint64_t> m_bits;             ///< Bit words, one bit per type.
+};
+
 ///////////////////////////////////////////////////////////////////////////
 /// \class      ecsEntity
 /// \brief      A base class representing components in an ECS architecture.
 /// \warning    Don't subclass, functionality derived from components/systems.
 struct ecsEntity final {
     EntityHandle m_handle;                                                        ///< Unique handle for this entity.
-    std::vector<std::tuple<ComponentID, int, ComponentHandle>> m_components = {}; ///< Vector of components.
+    std::vector<std::tuple<ComponentID, ComponentIndex, ComponentHandle>>
+        m_components = {};                                                        ///< Components and their rows.
+    ecsSignature m_signature = {};                                                ///< Component and tag types owned.
+    std::vector<std::pair<ComponentID, ComponentHandle>> m_sharedComponents = {}; ///< Shared values referenced.
+    ecsEntity* m_parent = nullptr;                                                ///< Parent entity, if any.
+    std::vector<ecsEntity*> m_children = {};                                      ///< Child entities.
+    bool m_enabled = true;                                                        ///< Visible to queries if true.
 };
 };     // namespace mini
 #endif // MINIECS_ECSENTITY_HPP
\ No newline at end of file
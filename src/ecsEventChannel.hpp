@@ -0,0 +1,222 @@
+#pragma once
+#ifndef MINIECS_ECSEVENTCHANNEL_HPP
+#define MINIECS_ECSEVENTCHANNEL_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace mini {
+///////////////////////////////////////////////////////////////////////////
+/// \class  ecsBaseEventChannel
+/// \brief  The type-erased base of an event channel, flipped by its world.
+class ecsBaseEventChannel {
+    public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Destroy this channel.
+    virtual ~ecsBaseEventChannel() = default;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Construct a channel.
+    ecsBaseEventChannel() = default;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Make the events sent so far readable, discarding those read before.
+    /// \note   Call at a sync point, while no thread sends or reads.
+    virtual void flip() = 0;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Discard every event, sent or readable.
+    /// \note   Call at a sync point, while no thread sends or reads.
+    virtual void discard() = 0;
+
+    private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Disallow copying a channel.
+    ecsBaseEventChannel(const ecsBaseEventChannel&) = delete;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Disallow channel copy assignment.
+    ecsBaseEventChannel& operator=(const ecsBaseEventChannel&) = delete;
+};
+
+///////////////////////////////////////////////////////////////////////////
+/// \class  ecsEventChannel
+/// \brief  A double-buffered stream of events of one type, passed between
+///         systems without touching entity storage.
+/// \note   Any thread may send, without locking. Events sent during a frame
+///         become readable once the channel flips, and stay readable until
+///         the next flip. Any number of readers may read them meanwhile.
+/// \tparam	Event           the event type.
+template <typename Event> class ecsEventChannel final : public ecsBaseEventChannel {
+    public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \class  Reader
+    /// \brief  A reader's position within a channel's readable events.
+    class Reader final {
+        size_t m_flipCount = 0ULL;    ///< The flip the position belongs to.
+        size_t m_position = 0ULL;     ///< Readable events already read.
+        friend class ecsEventChannel; ///< Allows the channel to advance readers.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Destroy this channel, discarding any remaining events.
+    ~ecsEventChannel() override {
+        discard();
+        for (auto& buffer : m_buffers) {
+            for (size_t segment = 0; segment < buffer.m_segments.size(); ++segment) {
+                if (auto* events = buffer.m_segments[segment].load(std::memory_order_relaxed)) {
+                    std::allocator<Event>().deallocate(events, getSegmentCapacity(segment));
+                }
+            }
+        }
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Construct an empty channel.
+    ecsEventChannel() = default;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Send an event, readable after the next flip.
+    /// \param	args				arguments to construct the event with.
+    template <typename... Args> void send(Args&&... args) {
+        auto& buffer = m_buffers[m_writeBuffer];
+        const auto index = buffer.m_count.fetch_add(1ULL, std::memory_order_relaxed);
+        const auto segment = getSegment(index);
+        new (getSegmentData(buffer, segment) + (index - getSegmentStart(segment))) Event(std::forward<Args>(args)...);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Read the events a reader hasn't read yet.
+    /// \param	reader				the reader's position, advanced by this.
+    /// \param	func				function called with each unread event, in send order per thread.
+    /// \return	the number of events read.
+    template <typename Function> size_t read(Reader& reader, Function&& func) const {
+        if (reader.m_flipCount != m_flipCount) {
+            reader.m_flipCount = m_flipCount;
+            reader.m_position = 0ULL;
+        }
+
+        // Segments are visited whole, keeping reads contiguous
+        const auto& buffer = m_buffers[m_writeBuffer ^ 1ULL];
+        const auto count = buffer.m_count.load(std::memory_order_relaxed);
+        const auto first = reader.m_position;
+        while (reader.m_position < count) {
+            const auto segment = getSegment(reader.m_position);
+            const auto start = getSegmentStart(segment);
+            const auto end = std::min<size_t>(count, start + getSegmentCapacity(segment));
+            const auto* events = buffer.m_segments[segment].load(std::memory_order_acquire);
+            for (auto index = reader.m_position; index < end; ++index) {
+                func(events[index - start]);
+            }
+            reader.m_position = end;
+        }
+        return count - first;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the number of readable events.
+    /// \return	the number of events sent before the last flip.
+    [[nodiscard]] size_t getReadableCount() const noexcept {
+        return m_buffers[m_writeBuffer ^ 1ULL].m_count.load(std::memory_order_relaxed);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the number of events sent since the last flip.
+    /// \return	the number of pending events.
+    [[nodiscard]] size_t getPendingCount() const noexcept {
+        return m_buffers[m_writeBuffer].m_count.load(std::memory_order_relaxed);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Make the events sent so far readable, discarding those read before.
+    /// \note   Call at a sync point, while no thread sends or reads.
+    void flip() override {
+        m_writeBuffer ^= 1ULL;
+        destroyEvents(m_buffers[m_writeBuffer]);
+        ++m_flipCount;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Discard every event, sent or readable, keeping their memory.
+    /// \note   Call at a sync point, while no thread sends or reads.
+    void discard() override {
+        for (auto& buffer : m_buffers) {
+            destroyEvents(buffer);
+        }
+        ++m_flipCount;
+    }
+
+    private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Events stored in segments which double in size, so sending never
+    ///         moves an event and segments stay allocated between frames.
+    struct Buffer {
+        std::array<std::atomic<Event*>, 32> m_segments = {}; ///< Segment storage, allocated on first use.
+        std::atomic<size_t> m_count = 0ULL;                  ///< Events sent into this buffer.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Find the segment holding an event.
+    /// \param	index				the event's index within its buffer.
+    /// \return	the index of the segment.
+    [[nodiscard]] static size_t getSegment(const size_t index) noexcept {
+        size_t segment(0ULL);
+        for (auto blocks = index / FIRST_SEGMENT_CAPACITY + 1ULL; blocks > 1ULL; blocks >>= 1ULL) {
+            ++segment;
+        }
+        return segment;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the index of a segment's first event.
+    /// \param	segment				the index of the segment.
+    /// \return	the number of events held by earlier segments.
+    [[nodiscard]] static size_t getSegmentStart(const size_t segment) noexcept {
+        return FIRST_SEGMENT_CAPACITY * ((1ULL << segment) - 1ULL);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the number of events a segment holds.
+    /// \param	segment				the index of the segment.
+    /// \return	the segment's capacity.
+    [[nodiscard]] static size_t getSegmentCapacity(const size_t segment) noexcept {
+        return FIRST_SEGMENT_CAPACITY << segment;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve a segment's storage, allocating it if no sender has yet.
+    /// \param	buffer				the buffer holding the segment.
+    /// \param	segment				the index of the segment.
+    /// \return	the segment's storage.
+    static Event* getSegmentData(Buffer& buffer, const size_t segment) {
+        auto* events = buffer.m_segments[segment].load(std::memory_order_acquire);
+        if (events != nullptr) {
+            return events;
+        }
+
+        // Senders racing to allocate keep the first segment installed
+        auto* allocated = std::allocator<Event>().allocate(getSegmentCapacity(segment));
+        if (buffer.m_segments[segment].compare_exchange_strong(
+                events, allocated, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return allocated;
+        }
+        std::allocator<Event>().deallocate(allocated, getSegmentCapacity(segment));
+        return events;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Destroy the events of a buffer, keeping its segments.
+    /// \param	buffer				the buffer to empty.
+    static void destroyEvents(Buffer& buffer) {
+        if constexpr (!std::is_trivially_destructible_v<Event>) {
+            const auto count = buffer.m_count.load(std::memory_order_relaxed);
+            for (size_t index = 0; index < count; ++index) {
+                const auto segment = getSegment(index);
+                buffer.m_segments[segment].load(std::memory_order_relaxed)[index - getSegmentStart(segment)].~Event();
+            }
+        }
+        buffer.m_count.store(0ULL, std::memory_order_relaxed);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    static constexpr size_t FIRST_SEGMENT_CAPACITY = 64ULL; ///< Events held by the first segment.
+    std::array<Buffer, 2> m_buffers;                        ///< The sending and readable buffers.
+    size_t m_writeBuffer = 0ULL;                            ///< Index of the sending buffer.
+    size_t m_flipCount = 0ULL;                              ///< Number of flips and discards so far.
+};
+};     // namespace mini
+#endif // MINIECS_ECSEVENTCHANNEL_HPP
\ No newline at end of file
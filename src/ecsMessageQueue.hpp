@@ -0,0 +1,76 @@
+#pragma once
+#ifndef MINIECS_ECSMESSAGEQUEUE_HPP
+#define MINIECS_ECSMESSAGEQUEUE_HPP
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+namespace mini {
+///////////////////////////////////////////////////////////////////////////
+/// \class  ecsMessageQueue
+/// \brief  An unbounded lock-free queue with many producers and one consumer.
+/// \note   Any thread may push, but only one thread at a time may pop.
+/// \tparam	T               the message type.
+template <typename T> class ecsMessageQueue final {
+    public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Destroy this queue, discarding any remaining messages.
+    ~ecsMessageQueue() {
+        while (pop()) {
+        }
+        delete m_tail;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Construct an empty queue.
+    ecsMessageQueue() : m_head(new Node()), m_tail(m_head.load(std::memory_order_relaxed)) {}
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Add a message to the back of the queue.
+    /// \param	message         the message to add.
+    void push(T message) {
+        auto* node = new Node();
+        node->m_message.emplace(std::move(message));
+        auto* previous = m_head.exchange(node, std::memory_order_acq_rel);
+        previous->m_next.store(node, std::memory_order_release);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Remove the message at the front of the queue.
+    /// \note   A message whose push hasn't completed yet isn't visible.
+    /// \return	the message on success, nothing if the queue is empty.
+    std::optional<T> pop() {
+        auto* next = m_tail->m_next.load(std::memory_order_acquire);
+        if (next == nullptr) {
+            return std::nullopt;
+        }
+
+        // The popped node becomes the new stub node
+        std::optional<T> message(std::move(next->m_message));
+        next->m_message.reset();
+        delete m_tail;
+        m_tail = next;
+        return message;
+    }
+
+    private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Disallow copying a queue.
+    ecsMessageQueue(const ecsMessageQueue&) = delete;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Disallow queue copy assignment.
+    ecsMessageQueue& operator=(const ecsMessageQueue&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  A single link in the queue.
+    struct Node {
+        std::optional<T> m_message;          ///< The message, empty for the stub.
+        std::atomic<Node*> m_next = nullptr; ///< The next node, if pushed.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    std::atomic<Node*> m_head; ///< Most recently pushed node.
+    Node* m_tail;              ///< Stub node preceding the front message.
+};
+};     // namespace mini
+#endif // MINIECS_ECSMESSAGEQUEUE_HPP
\ No newline at end of file
@@ -0,0 +1,17 @@
+#include "ecsObserver.hpp"
+
+///////////////////////////////////////////////////////////////////////////
+/// Use our shared namespace mini
+using namespace mini;
+
+///////////////////////////////////////////////////////////////////////////
+/// isValid
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsObserver::isValid() const noexcept { return !m_componentTypes.empty(); }
+
+///////////////////////////////////////////////////////////////////////////
+/// addComponentType
+///////////////////////////////////////////////////////////////////////////
+
+void ecsObserver::addComponentType(const ComponentID componentType) { m_componentTypes.emplace_back(componentType); }
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+#ifndef MINIECS_ECSOBSERVER_HPP
+#define MINIECS_ECSOBSERVER_HPP
+
+#include "ecsComponent.hpp"
+#include "ecsHandle.hpp"
+#include <vector>
+
+namespace mini {
+///////////////////////////////////////////////////////////////////////////
+/// \class  ecsObserver
+/// \brief  An interface notified of entities gaining or losing a signature.
+/// \note   Events are queued by the ecsWorld as entities change, and are
+///         delivered in batches whenever the world flushes its observers.
+class ecsObserver {
+    public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Virtual observer destructor.
+    virtual ~ecsObserver() = default;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Construct a base ecsObserver.
+    ecsObserver() = default;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Move a base observer.
+    ecsObserver(ecsObserver&&) = default;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Copy a base observer.
+    ecsObserver(const ecsObserver&) = default;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Move-assign a base observer.
+    ecsObserver& operator=(ecsObserver&&) = default;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Copy-assign a base observer.
+    ecsObserver& operator=(const ecsObserver&) = default;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieves the component types observed.
+    /// \return	the component types an entity must own to be observed.
+    [[nodiscard]] const std::vector<ComponentID>& getComponentTypes() const noexcept { return m_componentTypes; }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieves whether or not this observer has >= 1 component type.
+    /// \return true if the observer is valid, false otherwise.
+    [[nodiscard]] bool isValid() const noexcept;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Receive the entities which now own every observed type.
+    /// \param	entities	    the entities added since the last flush.
+    virtual void onEntitiesAdded(const std::vector<EntityHandle>& entities) = 0;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Receive the entities which no longer own every observed type.
+    /// \note   Delivered before additions, entities added and removed within
+    ///         the same batch are not reported at all.
+    /// \param	entities	    the entities removed since the last flush.
+    virtual void onEntitiesRemoved(const std::vector<EntityHandle>& entities) = 0;
+
+    protected:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Add a component or tag type to the observed signature.
+    /// \param	componentType	the type of component to observe.
+    void addComponentType(const ComponentID componentType);
+
+    private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    std::vector<ComponentID> m_componentTypes; ///< Observed component types.
+};
+};     // namespace mini
+#endif // MINIECS_ECSOBSERVER_HPP
\ No newline at end of file
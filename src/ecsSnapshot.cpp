@@ -0,0 +1,156 @@
+#include "ecsSnapshot.hpp"
+#include <algorithm>
+
+///////////////////////////////////////////////////////////////////////////
+/// Use our shared namespace mini
+using namespace mini;
+
+///////////////////////////////////////////////////////////////////////////
+/// ecsSnapshot
+///////////////////////////////////////////////////////////////////////////
+
+ecsSnapshot::ecsSnapshot(ecsSnapshot&& other) noexcept
+    : m_components(std::move(other.m_components)), m_entities(std::move(other.m_entities)),
+      m_slots(std::move(other.m_slots)), m_rows(std::move(other.m_rows)), m_frame(other.m_frame) {
+    other.m_components.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// operator=
+///////////////////////////////////////////////////////////////////////////
+
+ecsSnapshot& ecsSnapshot::operator=(ecsSnapshot&& other) noexcept {
+    if (this != &other) {
+        clear();
+        m_components = std::move(other.m_components);
+        m_entities = std::move(other.m_entities);
+        m_slots = std::move(other.m_slots);
+        m_rows = std::move(other.m_rows);
+        m_frame = other.m_frame;
+        other.m_components.clear();
+    }
+    return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// getRelevantComponents
+///////////////////////////////////////////////////////////////////////////
+
+std::vector<std::vector<const ecsBaseComponent*>> ecsSnapshot::getRelevantComponents(
+    const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes) const {
+    std::vector<std::vector<const ecsBaseComponent*>> components;
+    if (componentTypes.empty()) {
+        return components;
+    }
+
+    // Drive the query from the smallest required pool, if any
+    const ComponentDataSpace* driver = nullptr;
+    ComponentID driverID = -1;
+    for (const auto& [componentID, flag] : componentTypes) {
+        if (!ecsSystem::isRequired(flag)) {
+            continue;
+        }
+        const auto pos = m_components.find(componentID);
+        if (pos == m_components.cend() || pos->second.empty()) {
+            return components;
+        }
+        if (driver == nullptr || pos->second.size() / std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]) <
+                                     driver->size() / std::get<2>(ecsBaseComponent::m_componentRegistry[driverID])) {
+            driver = &pos->second;
+            driverID = componentID;
+        }
+    }
+
+    // Resolve a single entity's row, returning false if it doesn't qualify
+    bool hasAny = false;
+    for (const auto& componentType : componentTypes) {
+        hasAny |= componentType.second == ecsSystem::RequirementsFlag::ANY;
+    }
+    std::vector<const ecsBaseComponent*> row(componentTypes.size(), nullptr);
+    const auto resolveRow = [&](const EntityRecord& record) {
+        bool foundAny = false;
+        for (size_t j = 0; j < componentTypes.size(); ++j) {
+            const auto& [componentID, flag] = componentTypes[j];
+            const auto* component = getComponentInternal(record, componentID);
+            if (flag == ecsSystem::RequirementsFlag::EXCLUDE) {
+                if (component != nullptr) {
+                    return false;
+                }
+                row[j] = nullptr;
+                continue;
+            }
+            if (ecsSystem::isRequired(flag) && component == nullptr) {
+                return false;
+            }
+            foundAny |= flag == ecsSystem::RequirementsFlag::ANY && component != nullptr;
+            row[j] = component;
+        }
+        return !hasAny || foundAny;
+    };
+
+    if (driver == nullptr) {
+        // No required types, so every entity is a candidate
+        for (const auto& record : m_entities) {
+            if (resolveRow(record)) {
+                components.push_back(row);
+            }
+        }
+        return components;
+    }
+
+    const auto typeSize = std::get<2>(ecsBaseComponent::m_componentRegistry[driverID]);
+    components.reserve(driver->size() / typeSize);
+    for (size_t i = 0; i < driver->size(); i += typeSize) {
+        const auto* component = reinterpret_cast<const ecsBaseComponent*>(&(*driver)[i]);
+        const auto* record = findEntity(component->m_entityHandle);
+        if (record != nullptr && resolveRow(*record)) {
+            components.push_back(row);
+        }
+    }
+    return components;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// clear
+///////////////////////////////////////////////////////////////////////////
+
+void ecsSnapshot::clear() {
+    // Destruct the copies, but keep each pool's capacity for the next flip
+    for (auto& [componentID, mem_array] : m_components) {
+        const auto& freeFn = std::get<1>(ecsBaseComponent::m_componentRegistry[componentID]);
+        const auto typeSize = std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]);
+        if (freeFn != nullptr) {
+            for (size_t i = 0; i < mem_array.size(); i += typeSize) {
+                freeFn(reinterpret_cast<ecsBaseComponent*>(&mem_array[i]));
+            }
+        }
+        mem_array.clear();
+    }
+    m_entities.clear();
+    m_slots.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// findEntity
+///////////////////////////////////////////////////////////////////////////
+
+const ecsSnapshot::EntityRecord* ecsSnapshot::findEntity(const EntityHandle& entityHandle) const noexcept {
+    const auto pos = std::lower_bound(
+        m_entities.cbegin(), m_entities.cend(), entityHandle,
+        [](const EntityRecord& record, const EntityHandle& handle) { return record.m_handle < handle; });
+    return pos != m_entities.cend() && pos->m_handle == entityHandle ? &(*pos) : nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// getComponentInternal
+///////////////////////////////////////////////////////////////////////////
+
+const ecsBaseComponent*
+ecsSnapshot::getComponentInternal(const EntityRecord& record, const ComponentID componentID) const noexcept {
+    for (size_t i = record.m_firstSlot; i < record.m_firstSlot + record.m_slotCount; ++i) {
+        if (m_slots[i].first == componentID) {
+            return reinterpret_cast<const ecsBaseComponent*>(&m_components.at(componentID)[m_slots[i].second]);
+        }
+    }
+    return nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+#pragma once
+#ifndef MINIECS_ECSSNAPSHOT_HPP
+#define MINIECS_ECSSNAPSHOT_HPP
+
+#include "ecsComponent.hpp"
+#include "ecsHandle.hpp"
+#include "ecsSystem.hpp"
+#include <array>
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace mini {
+///////////////////////////////////////////////////////////////////////////
+/// \class  ecsSnapshot
+/// \brief  A read-only copy of an ecsWorld's double-buffered components,
+///         taken at a frame boundary.
+/// \note   Queries never modify the snapshot, so any number of threads may
+///         read it while the world it was taken from keeps updating.
+class ecsSnapshot final {
+    public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Destroy this snapshot.
+    ~ecsSnapshot() { clear(); }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Construct an empty snapshot.
+    ecsSnapshot() = default;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Move a snapshot.
+    /// \param	other				another snapshot to move to here.
+    ecsSnapshot(ecsSnapshot&& other) noexcept;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Move the data from another snapshot into this.
+    /// \param	other		        another snapshot to move the data from.
+    /// \return				        reference to this.
+    ecsSnapshot& operator=(ecsSnapshot&& other) noexcept;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the frame this snapshot was taken at.
+    /// \return	the world's flip count when taken, 0 if never taken.
+    [[nodiscard]] size_t getFrame() const noexcept { return m_frame; }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Search for a component type in an entity.
+    /// \tparam	Component           the category of component being retrieved.
+    /// \param	entityHandle	    handle to the entity to retrieve from.
+    /// \return	a component of type requested on success, nullptr otherwise.
+    template <typename Component>[[nodiscard]] const Component* getComponent(const EntityHandle& entityHandle) const {
+        const auto* record = findEntity(entityHandle);
+        return record == nullptr ? nullptr
+                                 : dynamic_cast<const Component*>(getComponentInternal(*record, Component::Runtime_ID));
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve a list of entity components corresponding to the input.
+    /// \note   Only double-buffered types are present in a snapshot, so
+    ///         requiring any other type yields no rows. Change filters only
+    ///         require their types, as snapshots have no last run to compare.
+    /// \tparam	T_types             const pointer types, one per component type.
+    /// \param	componentTypes		list of component types to retrieve.
+    template <typename... T_types>
+    [[nodiscard]] std::vector<std::tuple<T_types...>>
+    getComponents(const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes) const {
+        std::vector<std::tuple<T_types...>> entityComponents;
+
+        // Cast each component set to the types requested
+        for (const auto& groupedComponents : getRelevantComponents(componentTypes)) {
+            // Convert the component set to a standard array
+            std::array<const ecsBaseComponent*, sizeof...(T_types)> arr;
+            std::copy_n(groupedComponents.cbegin(), sizeof...(T_types), arr.begin());
+
+            // Cast the array to our types and emplace it back in our vector
+            std::apply(
+                [&entityComponents](auto&... args) { entityComponents.emplace_back(dynamic_cast<T_types>(args)...); },
+                arr);
+        }
+        return entityComponents;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the components matching a set of component types.
+    /// \param	componentTypes		list of component types to retrieve.
+    /// \return	list of component rows, one per matching entity.
+    [[nodiscard]] std::vector<std::vector<const ecsBaseComponent*>>
+    getRelevantComponents(const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes) const;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Destruct all components, keeping memory for the next flip.
+    void clear();
+
+    private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Disallow copying a snapshot.
+    ecsSnapshot(const ecsSnapshot&) = delete;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Disallow snapshot copy assignment.
+    ecsSnapshot& operator=(const ecsSnapshot&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  An entity's range of component slots within the snapshot.
+    struct EntityRecord {
+        EntityHandle m_handle;     ///< Handle of the entity.
+        size_t m_firstSlot = 0ULL; ///< Index of the entity's first slot.
+        size_t m_slotCount = 0ULL; ///< Number of slots the entity owns.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Find the record of an entity in the snapshot.
+    /// \param	entityHandle	    handle to the entity to find.
+    /// \return	pointer to the record on success, nullptr otherwise.
+    [[nodiscard]] const EntityRecord* findEntity(const EntityHandle& entityHandle) const noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve an entity's component of a specific class.
+    /// \param	record			    the entity's record.
+    /// \param	componentID			the runtime class ID of the component.
+    /// \return the specific component on success, nullptr otherwise.
+    [[nodiscard]] const ecsBaseComponent*
+    getComponentInternal(const EntityRecord& record, const ComponentID componentID) const noexcept;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    std::map<ComponentID, ComponentDataSpace> m_components; ///< Copied component data.
+    std::vector<EntityRecord> m_entities;                   ///< Entity records, sorted by handle.
+    std::vector<std::pair<ComponentID, size_t>> m_slots;    ///< Component class and offset per slot.
+    std::vector<std::tuple<EntityHandle, ComponentID, size_t>>
+        m_rows;                                             ///< Owner of each copied row, reused between flips.
+    size_t m_frame = 0ULL;                                  ///< Flip count when taken.
+    friend class ecsWorld;                                  ///< Allows the ecsWorld to fill this.
+};
+};     // namespace mini
+#endif // MINIECS_ECSSNAPSHOT_HPP
\ No newline at end of file
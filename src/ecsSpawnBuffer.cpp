@@ -0,0 +1,144 @@
+#include "ecsSpawnBuffer.hpp"
+#include "ecsWorld.hpp"
+
+///////////////////////////////////////////////////////////////////////////
+/// Use our shared namespace mini
+using namespace mini;
+
+///////////////////////////////////////////////////////////////////////////
+/// ecsSpawnBuffer
+///////////////////////////////////////////////////////////////////////////
+
+ecsSpawnBuffer::ecsSpawnBuffer(ecsSpawnBuffer&& other) noexcept
+    : m_entities(std::move(other.m_entities)), m_entityIndices(std::move(other.m_entityIndices)),
+      m_components(std::move(other.m_components)), m_nextUUID(other.m_nextUUID), m_endUUID(other.m_endUUID) {
+    other.m_entities.clear();
+    other.m_entityIndices.clear();
+    other.m_components.clear();
+    other.m_nextUUID = other.m_endUUID;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// operator=
+///////////////////////////////////////////////////////////////////////////
+
+ecsSpawnBuffer& ecsSpawnBuffer::operator=(ecsSpawnBuffer&& other) noexcept {
+    if (this != &other) {
+        clear();
+        m_entities = std::move(other.m_entities);
+        m_entityIndices = std::move(other.m_entityIndices);
+        m_components = std::move(other.m_components);
+        m_nextUUID = other.m_nextUUID;
+        m_endUUID = other.m_endUUID;
+        other.m_entities.clear();
+        other.m_entityIndices.clear();
+        other.m_components.clear();
+        other.m_nextUUID = other.m_endUUID;
+    }
+    return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// makeEntity
+///////////////////////////////////////////////////////////////////////////
+
+EntityHandle ecsSpawnBuffer::makeEntity(const ecsBaseComponent* const* const components, const size_t numComponents) {
+    const auto UUID = EntityHandle(generateUUID());
+    m_entityIndices.emplace(UUID, m_entities.size());
+    m_entities.push_back(ecsEntity{ UUID, {}, {} });
+
+    // Stage all components directly into the entity
+    for (size_t i = 0; i < numComponents; ++i) {
+        [[maybe_unused]] const auto componentHandle = makeComponent(UUID, components[i]);
+    }
+
+    return UUID;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// makeComponent
+///////////////////////////////////////////////////////////////////////////
+
+ComponentHandle
+ecsSpawnBuffer::makeComponent(const EntityHandle& entityHandle, const ecsBaseComponent* const component) {
+    return makeComponentInternal(entityHandle, component->m_runtimeID, component);
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// clear
+///////////////////////////////////////////////////////////////////////////
+
+void ecsSpawnBuffer::clear() {
+    // Destruct the staged components, but keep each pool's capacity
+    for (auto& [componentID, mem_array] : m_components) {
+        const auto& freeFn = std::get<1>(ecsBaseComponent::m_componentRegistry[componentID]);
+        const auto typeSize = std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]);
+        if (freeFn != nullptr) {
+            for (size_t i = 0; i < mem_array.size(); i += typeSize) {
+                freeFn(reinterpret_cast<ecsBaseComponent*>(&mem_array[i]));
+            }
+        }
+        mem_array.clear();
+    }
+    m_entities.clear();
+    m_entityIndices.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// makeComponentInternal
+///////////////////////////////////////////////////////////////////////////
+
+ComponentHandle ecsSpawnBuffer::makeComponentInternal(
+    const EntityHandle& entityHandle, const ComponentID componentID, const ecsBaseComponent* const component) {
+    // Tags and unknown classes have no data to stage
+    if (static_cast<size_t>(componentID) >= ecsBaseComponent::m_componentRegistry.size() ||
+        std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]) == 0ULL) {
+        return ComponentHandle();
+    }
+    auto* entity = findEntity(entityHandle);
+    if (entity == nullptr) {
+        return ComponentHandle();
+    }
+
+    // Prevent adding duplicate component types to the same entity
+    for (auto& [ID, fn, compHandle] : entity->m_components) {
+        if (ID == componentID) {
+            return compHandle;
+        }
+    }
+
+    // Rows are relative to the staged pool until spliced into a world
+    auto UUID = ComponentHandle(generateUUID());
+    const auto& createfn = std::get<0>(ecsBaseComponent::m_componentRegistry[componentID]);
+    entity->m_components.emplace_back(
+        componentID, createfn(m_components[componentID], UUID, entity->m_handle, component), UUID);
+    entity->m_signature.set(componentID);
+    return UUID;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// findEntity
+///////////////////////////////////////////////////////////////////////////
+
+ecsEntity* ecsSpawnBuffer::findEntity(const EntityHandle& entityHandle) noexcept {
+    // Components are usually staged right after their entity
+    if (!m_entities.empty() && m_entities.back().m_handle == entityHandle) {
+        return &m_entities.back();
+    }
+    const auto pos = m_entityIndices.find(entityHandle);
+    return pos == m_entityIndices.end() ? nullptr : &m_entities[pos->second];
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// generateUUID
+///////////////////////////////////////////////////////////////////////////
+
+ecsHandle ecsSpawnBuffer::generateUUID() {
+    // Reserve handles in blocks, keeping the shared counter uncontended
+    constexpr auto blockSize = 256ULL;
+    if (m_nextUUID == m_endUUID) {
+        m_nextUUID = ecsWorld::reserveUUIDs(blockSize);
+        m_endUUID = m_nextUUID + blockSize;
+    }
+    return ecsWorld::makeUUID(m_nextUUID++);
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+#pragma once
+#ifndef MINIECS_ECSSPAWNBUFFER_HPP
+#define MINIECS_ECSSPAWNBUFFER_HPP
+
+#include "ecsComponent.hpp"
+#include "ecsEntity.hpp"
+#include "ecsHandle.hpp"
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace mini {
+///////////////////////////////////////////////////////////////////////////
+/// \class  ecsSpawnBuffer
+/// \brief  Stages new entities and components away from any ecsWorld.
+/// \note   Each thread should own its own buffer, as buffers share no state
+///         beyond handle reservation. Staged entities join a world when it
+///         splices the buffer in, at a point where the world isn't in use.
+class ecsSpawnBuffer final {
+    public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Destroy this buffer, discarding anything staged.
+    ~ecsSpawnBuffer() { clear(); }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Construct an empty buffer.
+    ecsSpawnBuffer() = default;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Move a buffer.
+    /// \param	other				another buffer to move to here.
+    ecsSpawnBuffer(ecsSpawnBuffer&& other) noexcept;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Move the data from another buffer into this.
+    /// \param	other		        another buffer to move the data from.
+    /// \return				        reference to this.
+    ecsSpawnBuffer& operator=(ecsSpawnBuffer&& other) noexcept;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Stage an entity from an optional list of components.
+    /// \param	components			array of component pointers to hard copy.
+    /// \param	numComponents		the number of components in the array.
+    /// \return handle to this new entity.
+    EntityHandle
+    makeEntity(const ecsBaseComponent* const* const components = nullptr, const size_t numComponents = 0ULL);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Stage a new component for a staged entity.
+    /// \param	entityHandle		handle to the component's parent entity.
+    /// \param	component			the component being added.
+    /// \return handle to this new component.
+    ComponentHandle makeComponent(const EntityHandle& entityHandle, const ecsBaseComponent* const component);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Stage a component from the input template parameter.
+    /// \param	entityHandle		handle to the component's parent entity.
+    /// \return handle to this new component.
+    template <typename Component> ComponentHandle makeComponent(const EntityHandle& entityHandle) {
+        return makeComponentInternal(entityHandle, Component::Runtime_ID, nullptr);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Add a tag to a staged entity.
+    /// \tparam	Tag                 the class type of tag.
+    /// \param	entityHandle		handle to the entity to be tagged.
+    /// \return	true on success, false otherwise.
+    template <typename Tag> bool addTag(const EntityHandle& entityHandle) {
+        auto* entity = findEntity(entityHandle);
+        if (entity == nullptr) {
+            return false;
+        }
+        entity->m_signature.set(Tag::Runtime_ID);
+        return true;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the number of staged entities.
+    /// \return	the number of staged entities.
+    [[nodiscard]] size_t size() const noexcept { return m_entities.size(); }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Check if nothing is staged.
+    /// \return	true if empty, false otherwise.
+    [[nodiscard]] bool empty() const noexcept { return m_entities.empty(); }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Discard everything staged, keeping memory for reuse.
+    void clear();
+
+    private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Disallow copying a buffer.
+    ecsSpawnBuffer(const ecsSpawnBuffer&) = delete;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Disallow buffer copy assignment.
+    ecsSpawnBuffer& operator=(const ecsSpawnBuffer&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Stage a component of a specific class for a staged entity.
+    /// \param	entityHandle		handle to the component's parent entity.
+    /// \param	componentID			the runtime component class.
+    /// \param  component			optional component to copy from.
+    /// \return handle to this new component.
+    ComponentHandle makeComponentInternal(
+        const EntityHandle& entityHandle, const ComponentID componentID, const ecsBaseComponent* const component);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Find a staged entity, checking the most recent first.
+    /// \param	entityHandle		handle to the entity to find.
+    /// \return	pointer to the entity on success, nullptr otherwise.
+    [[nodiscard]] ecsEntity* findEntity(const EntityHandle& entityHandle) noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Generate a handle from this buffer's reserved block.
+    /// \return	a UUID.
+    [[nodiscard]] ecsHandle generateUUID();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    std::vector<ecsEntity> m_entities;                      ///< Staged entities, in staging order.
+    std::map<EntityHandle, size_t> m_entityIndices;         ///< Index of each staged entity.
+    std::map<ComponentID, ComponentDataSpace> m_components; ///< Staged component data.
+    uint64_t m_nextUUID = 0ULL;                             ///< Next sequence in the reserved block.
+    uint64_t m_endUUID = 0ULL;                              ///< End of the reserved block.
+    friend class ecsWorld;                                  ///< Allows the ecsWorld to splice this in.
+};
+};     // namespace mini
+#endif // MINIECS_ECSSPAWNBUFFER_HPP
\ No newline at end of file
@@ -0,0 +1,326 @@
+#pragma once
+#ifndef MINIECS_ECSSTATICWORLD_HPP
+#define MINIECS_ECSSTATICWORLD_HPP
+
+#include "ecsHandle.hpp"
+#include "ecsWorld.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mini {
+///////////////////////////////////////////////////////////////////////////
+/// \class  ecsStaticWorld
+/// \brief  A set of entities whose component classes are fixed at compile
+///         time, stored in typed pools and resolved with constant indices.
+/// \note   Component classes needn't derive from ecsComponent, and so needn't
+///         be registered at all, unless converting to or from an ecsWorld.
+/// \tparam	Components          the component classes, at most 64.
+template <typename... Components> class ecsStaticWorld final {
+    static_assert(sizeof...(Components) <= 64U, "ecsStaticWorld supports at most 64 component classes");
+
+    public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Bit mask of the component classes an entity owns.
+    using Signature = uint64_t;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the constant index of a component class.
+    /// \tparam	C                   the component class.
+    /// \return	the index of the class, or the class count if not present.
+    template <typename C>[[nodiscard]] static constexpr size_t indexOf() noexcept {
+        constexpr bool matches[] = { std::is_same_v<C, Components>... };
+        size_t index = 0ULL;
+        while (index < sizeof...(Components) && !matches[index]) {
+            ++index;
+        }
+        return index;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the signature mask of a set of component classes.
+    /// \tparam	Cs                  the component classes.
+    /// \return	the mask with a bit set per class.
+    template <typename... Cs>[[nodiscard]] static constexpr Signature maskOf() noexcept {
+        return ((Signature(1ULL) << indexOf<Cs>()) | ... | Signature(0ULL));
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Create an empty entity.
+    /// \return handle to this new entity.
+    EntityHandle makeEntity() {
+        const auto UUID = EntityHandle(ecsWorld::generateUUID());
+        insertEntity(UUID);
+        return UUID;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Adds a new component for the specified entity.
+    /// \note   The pointer is invalidated when components of its class are
+    ///         added or removed.
+    /// \tparam	C                   the component class.
+    /// \param	entityHandle		handle to the component's parent entity.
+    /// \param	component			the component to copy.
+    /// \return	the new component, the existing one if present, nullptr if
+    ///         the entity isn't found.
+    template <typename C> C* makeComponent(const EntityHandle& entityHandle, const C& component = C()) {
+        constexpr auto index = checkedIndexOf<C>();
+        const auto pos = m_index.find(entityHandle);
+        if (pos == m_index.end()) {
+            return nullptr;
+        }
+
+        auto& entity = m_entities[pos->second];
+        auto& pool = std::get<index>(m_pools);
+        if ((entity.m_signature & maskOf<C>()) == 0ULL) {
+            entity.m_signature |= maskOf<C>();
+            entity.m_rows[index] = pool.m_data.size();
+            pool.m_data.push_back(component);
+            pool.m_owners.push_back(pos->second);
+            if constexpr (std::is_base_of_v<ecsBaseComponent, C>) {
+                pool.m_data.back().m_entityHandle = entityHandle;
+            }
+        }
+        return &pool.m_data[entity.m_rows[index]];
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Search for a component class in an entity.
+    /// \tparam	C                   the component class.
+    /// \param	entityHandle	    handle to the entity to retrieve from.
+    /// \return	the component on success, nullptr otherwise.
+    template <typename C>[[nodiscard]] C* getComponent(const EntityHandle& entityHandle) noexcept {
+        return const_cast<C*>(std::as_const(*this).template getComponent<C>(entityHandle));
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Search for a component class in an entity.
+    /// \tparam	C                   the component class.
+    /// \param	entityHandle	    handle to the entity to retrieve from.
+    /// \return	the component on success, nullptr otherwise.
+    template <typename C>[[nodiscard]] const C* getComponent(const EntityHandle& entityHandle) const noexcept {
+        constexpr auto index = checkedIndexOf<C>();
+        const auto pos = m_index.find(entityHandle);
+        if (pos == m_index.end() || (m_entities[pos->second].m_signature & maskOf<C>()) == 0ULL) {
+            return nullptr;
+        }
+        return &std::get<index>(m_pools).m_data[m_entities[pos->second].m_rows[index]];
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Remove a component class from the specified entity.
+    /// \tparam	C                   the component class.
+    /// \param	entityHandle		handle to the entity to be modified.
+    /// \return	true on successful removal, false otherwise.
+    template <typename C> bool removeComponent(const EntityHandle& entityHandle) {
+        static_assert(checkedIndexOf<C>() < sizeof...(Components));
+        const auto pos = m_index.find(entityHandle);
+        if (pos == m_index.end() || (m_entities[pos->second].m_signature & maskOf<C>()) == 0ULL) {
+            return false;
+        }
+        removeRow<C>(pos->second);
+        return true;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Remove an entity and all of its components.
+    /// \param	entityHandle		handle to the entity to be removed.
+    /// \return	true on successful removal, false otherwise.
+    bool removeEntity(const EntityHandle& entityHandle) {
+        const auto pos = m_index.find(entityHandle);
+        if (pos == m_index.end()) {
+            return false;
+        }
+
+        // Remove its components, then fill its place with the last entity
+        const auto entityIndex = pos->second;
+        (removeRowIfPresent<Components>(entityIndex), ...);
+        m_index.erase(pos);
+        const auto lastIndex = m_entities.size() - 1ULL;
+        if (entityIndex != lastIndex) {
+            m_entities[entityIndex] = std::move(m_entities[lastIndex]);
+            m_index[m_entities[entityIndex].m_handle] = entityIndex;
+            (relinkOwner<Components>(entityIndex), ...);
+        }
+        m_entities.pop_back();
+        return true;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Visit every entity owning a set of component classes.
+    /// \note   The world mustn't be structurally modified while visiting.
+    /// \tparam	Cs                  the component classes required.
+    /// \param	func				function taking a reference per class.
+    template <typename... Cs, typename Func> void forEach(Func&& func) {
+        static_assert(sizeof...(Cs) > 0U, "forEach requires at least one component class");
+        constexpr auto mask = maskOf<Cs...>();
+
+        // Drive the query from the smallest pool
+        const std::array<const std::vector<size_t>*, sizeof...(Cs)> owners = {
+            &std::get<checkedIndexOf<Cs>()>(m_pools).m_owners...
+        };
+        const auto* driver = *std::min_element(owners.cbegin(), owners.cend(), [](const auto* a, const auto* b) {
+            return a->size() < b->size();
+        });
+        for (const auto owner : *driver) {
+            const auto& entity = m_entities[owner];
+            if ((entity.m_signature & mask) == mask) {
+                func(std::get<indexOf<Cs>()>(m_pools).m_data[entity.m_rows[indexOf<Cs>()]]...);
+            }
+        }
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the components of every entity owning a set of classes.
+    /// \tparam	Cs                  the component classes required.
+    /// \return	list of component rows, one per matching entity.
+    template <typename... Cs>[[nodiscard]] std::vector<std::tuple<Cs*...>> getComponents() {
+        std::vector<std::tuple<Cs*...>> components;
+        forEach<Cs...>([&components](Cs&... args) { components.emplace_back(&args...); });
+        return components;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the number of entities.
+    /// \return	the number of entities.
+    [[nodiscard]] size_t size() const noexcept { return m_entities.size(); }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Clear the data out of this world.
+    void clear() {
+        m_entities.clear();
+        m_index.clear();
+        std::apply([](auto&... pools) { (pools.clear(), ...); }, m_pools);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Copy every entity into a dynamic world, keeping their handles.
+    /// \param	world				the world to copy into.
+    void exportTo(ecsWorld& world) const {
+        static_assert((std::is_base_of_v<ecsBaseComponent, Components> && ...), "Components must be ecsComponents");
+        for (const auto& entity : m_entities) {
+            auto target = world.getEntity(entity.m_handle);
+            if (target == nullptr) {
+                world.insertEntity(ecsEntity{ entity.m_handle, {}, {} });
+                target = world.getEntity(entity.m_handle);
+            }
+            (exportComponent<Components>(entity, world, *target), ...);
+        }
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Copy every entity of a dynamic world in, keeping their handles.
+    /// \note   Components of classes outside this world's set are skipped.
+    /// \param	world				the world to copy from.
+    void importFrom(const ecsWorld& world) {
+        static_assert((std::is_base_of_v<ecsBaseComponent, Components> && ...), "Components must be ecsComponents");
+        for (const auto& [entityHandle, entity] : world.m_entities) {
+            if (m_index.find(entityHandle) == m_index.end()) {
+                insertEntity(entityHandle);
+            }
+            (importComponent<Components>(world, *entity), ...);
+        }
+    }
+
+    private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  The components of a single class, and their owners.
+    /// \tparam	C                   the component class.
+    template <typename C> struct Pool {
+        std::vector<C> m_data;        ///< Components of this class.
+        std::vector<size_t> m_owners; ///< Index of each component's entity.
+
+        ///////////////////////////////////////////////////////////////////////////
+        /// \brief  Remove every component.
+        void clear() noexcept {
+            m_data.clear();
+            m_owners.clear();
+        }
+    };
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  An entity, its signature and the rows of its components.
+    struct Entity {
+        EntityHandle m_handle;                              ///< Unique handle for this entity.
+        Signature m_signature = 0ULL;                       ///< Component classes owned.
+        std::array<size_t, sizeof...(Components)> m_rows{}; ///< Row per class owned.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the index of a component class, which must be present.
+    /// \tparam	C                   the component class.
+    /// \return	the index of the class.
+    template <typename C>[[nodiscard]] static constexpr size_t checkedIndexOf() noexcept {
+        static_assert(indexOf<C>() < sizeof...(Components), "Component class not part of this ecsStaticWorld");
+        return indexOf<C>();
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Insert an empty entity with a specific handle.
+    /// \param	entityHandle		handle to the new entity.
+    void insertEntity(const EntityHandle& entityHandle) {
+        m_index.emplace(entityHandle, m_entities.size());
+        m_entities.push_back(Entity{ entityHandle });
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Remove an entity's component, filling its row with the last.
+    /// \tparam	C                   the component class.
+    /// \param	entityIndex			index of the entity, which owns the class.
+    template <typename C> void removeRow(const size_t entityIndex) {
+        constexpr auto index = indexOf<C>();
+        auto& pool = std::get<index>(m_pools);
+        auto& entity = m_entities[entityIndex];
+        const auto row = entity.m_rows[index];
+        const auto lastRow = pool.m_data.size() - 1ULL;
+        if (row != lastRow) {
+            pool.m_data[row] = std::move(pool.m_data[lastRow]);
+            pool.m_owners[row] = pool.m_owners[lastRow];
+            m_entities[pool.m_owners[row]].m_rows[index] = row;
+        }
+        pool.m_data.pop_back();
+        pool.m_owners.pop_back();
+        entity.m_signature &= ~maskOf<C>();
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Remove an entity's component, if it owns one of the class.
+    /// \tparam	C                   the component class.
+    /// \param	entityIndex			index of the entity.
+    template <typename C> void removeRowIfPresent(const size_t entityIndex) {
+        if ((m_entities[entityIndex].m_signature & maskOf<C>()) != 0ULL) {
+            removeRow<C>(entityIndex);
+        }
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Point a moved entity's component back at its new index.
+    /// \tparam	C                   the component class.
+    /// \param	entityIndex			the entity's new index.
+    template <typename C> void relinkOwner(const size_t entityIndex) {
+        const auto& entity = m_entities[entityIndex];
+        if ((entity.m_signature & maskOf<C>()) != 0ULL) {
+            std::get<indexOf<C>()>(m_pools).m_owners[entity.m_rows[indexOf<C>()]] = entityIndex;
+        }
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Copy an entity's component of a class into a dynamic world.
+    /// \tparam	C                   the component class.
+    /// \param	entity      		the entity to copy from.
+    /// \param	world				the world to copy into.
+    /// \param	target      		the entity to copy into.
+    template <typename C> void exportComponent(const Entity& entity, ecsWorld& world, ecsEntity& target) const {
+        if ((entity.m_signature & maskOf<C>()) != 0ULL) {
+            const auto& component = std::get<indexOf<C>()>(m_pools).m_data[entity.m_rows[indexOf<C>()]];
+            [[maybe_unused]] const auto componentHandle = world.makeComponent(target, &component);
+        }
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Copy an entity's component of a class from a dynamic world.
+    /// \tparam	C                   the component class.
+    /// \param	world				the world to copy from.
+    /// \param	entity      		the entity to copy from.
+    template <typename C> void importComponent(const ecsWorld& world, const ecsEntity& entity) {
+        if (const auto* component = world.getComponentInternal(entity, C::Runtime_ID)) {
+            makeComponent<C>(entity.m_handle, *static_cast<const C*>(component));
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    std::tuple<Pool<Components>...> m_pools; ///< Typed component pools.
+    std::vector<Entity> m_entities;          ///< Densely packed entities.
+    std::map<EntityHandle, size_t> m_index;  ///< Index of each entity by handle.
+};
+};     // namespace mini
+#endif // MINIECS_ECSSTATICWORLD_HPP
\ No newline at end of file
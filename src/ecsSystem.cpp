@@ -10,21 +10,81 @@ using namespace mini;
 
 bool ecsSystem::isValid() const noexcept {
     for (const auto& [componentID, componentFlag] : m_componentTypes) {
-        if (componentFlag == RequirementsFlag::REQUIRED) {
+        if (isRequired(componentFlag)) {
             return true;
         }
     }
     return false;
 }
 
+///////////////////////////////////////////////////////////////////////////
+/// setUpdateInterval
+///////////////////////////////////////////////////////////////////////////
+
+void ecsSystem::setUpdateInterval(const size_t ticks) noexcept { m_updateInterval = std::max<size_t>(ticks, 1ULL); }
+
+///////////////////////////////////////////////////////////////////////////
+/// setFixedTimestep
+///////////////////////////////////////////////////////////////////////////
+
+void ecsSystem::setFixedTimestep(const double timestep, const size_t maxSteps) noexcept {
+    m_fixedTimestep = std::max(timestep, 0.0);
+    m_maxSteps = std::max<size_t>(maxSteps, 1ULL);
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// setTimeSlice
+///////////////////////////////////////////////////////////////////////////
+
+void ecsSystem::setTimeSlice(const size_t rowsPerUpdate) noexcept {
+    m_sliceSize = rowsPerUpdate;
+    m_cursor = SliceCursor();
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// advanceClock
+///////////////////////////////////////////////////////////////////////////
+
+size_t ecsSystem::advanceClock(const double deltaTime, double& stepTime) noexcept {
+    m_elapsedTime += deltaTime;
+    if (++m_tickCount < m_updateInterval) {
+        return 0ULL;
+    }
+    m_tickCount = 0ULL;
+
+    // Variable steps consume all the time accumulated since the last run
+    if (m_fixedTimestep <= 0.0) {
+        stepTime = m_elapsedTime;
+        m_elapsedTime = 0.0;
+        return 1ULL;
+    }
+
+    // Fixed steps consume whole steps, leaving the remainder for later, time past the cap is dropped
+    const auto wholeSteps = static_cast<size_t>(m_elapsedTime / m_fixedTimestep);
+    const auto steps = std::min(wholeSteps, m_maxSteps);
+    m_elapsedTime -= static_cast<double>(wholeSteps) * m_fixedTimestep;
+    stepTime = m_fixedTimestep;
+    return steps;
+}
+
 ///////////////////////////////////////////////////////////////////////////
 /// addComponentType
 ///////////////////////////////////////////////////////////////////////////
 
-void ecsSystem::addComponentType(const ComponentID componentType, const RequirementsFlag componentFlag) {
+void ecsSystem::addComponentType(
+    const ComponentID componentType, const RequirementsFlag componentFlag, const bool written) {
     m_componentTypes.emplace_back(componentType, componentFlag);
+    if (written) {
+        m_writtenTypes.emplace_back(componentType);
+    }
 }
 
+///////////////////////////////////////////////////////////////////////////
+/// addSingletonType
+///////////////////////////////////////////////////////////////////////////
+
+void ecsSystem::addSingletonType(const ComponentID componentType) { m_singletonTypes.emplace_back(componentType); }
+
 ///////////////////////////////////////////////////////////////////////////
 /// addSystem
 ///////////////////////////////////////////////////////////////////////////
@@ -3,9 +3,14 @@
 #define MINIECS_ECSYSTEM_HPP
 
 #include "ecsComponent.hpp"
+#include "ecsHandle.hpp"
 #include <vector>
 
 namespace mini {
+///////////////////////////////////////////////////////////////////////////
+/// Forward Declarations
+class ecsWorld;
+
 ///////////////////////////////////////////////////////////////////////////
 /// \class  ecsSystem
 /// \brief  An interface for an ecsSystem.
@@ -13,9 +18,19 @@ class ecsSystem {
     public:
     ///////////////////////////////////////////////////////////////////////////
     /// \brief  Component flag types.
+    /// \note   EXCLUDE rejects entities owning the type, and ANY requires at
+    ///         least one of the query's ANY types. Both are evaluated against
+    ///         entity signatures, and like tags yield nullptr columns unless
+    ///         an ANY type is a present component. CHANGED and ADDED require
+    ///         the type like REQUIRED, but only yield rows whose component was
+    ///         marked changed, or was added, since the system's last run.
     enum class RequirementsFlag {
         REQUIRED,
         OPTIONAL,
+        EXCLUDE,
+        ANY,
+        CHANGED,
+        ADDED,
     };
 
     ///////////////////////////////////////////////////////////////////////////
@@ -45,9 +60,51 @@ class ecsSystem {
         return m_componentTypes;
     }
     ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieves the singleton types required by this system.
+    /// \return	the singleton types required by this system.
+    [[nodiscard]] const std::vector<ComponentID>& getSingletonTypes() const noexcept { return m_singletonTypes; }
+    ///////////////////////////////////////////////////////////////////////////
     /// \brief  Retrieves whether or not this system >= 1 mandatory component.
     /// \return true if the system is valid, false otherwise.
     [[nodiscard]] bool isValid() const noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Check if a flag requires its component type to be present.
+    /// \param	componentFlag	the flag to check.
+    /// \return	true for REQUIRED and the change filters, false otherwise.
+    [[nodiscard]] static constexpr bool isRequired(const RequirementsFlag componentFlag) noexcept {
+        return componentFlag == RequirementsFlag::REQUIRED || componentFlag == RequirementsFlag::CHANGED ||
+               componentFlag == RequirementsFlag::ADDED;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Run this system only once every few updates.
+    /// \note   The time of skipped updates accumulates into the next one.
+    /// \param	ticks	        the number of updates per run, 1 for every update.
+    void setUpdateInterval(const size_t ticks) noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Run this system in fixed time steps, using an accumulator.
+    /// \note   Each update runs the system as many times as whole steps have
+    ///         accumulated, possibly zero. Steps past the limit are dropped
+    ///         along with their time, so one long update can't snowball.
+    /// \param	timestep	    the fixed step length, 0 to use each update's time.
+    /// \param	maxSteps	    the most steps run per update, at least 1.
+    void setFixedTimestep(const double timestep, const size_t maxSteps = 8ULL) noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Limit each run of this system to a slice of its query.
+    /// \note   Runs resume where the previous slice ended, following the next
+    ///         entity to its new position if the world changed in between.
+    /// \param	rowsPerUpdate	the number of driving rows per run, 0 for all.
+    void setTimeSlice(const size_t rowsPerUpdate) noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the number of driving rows this system runs over.
+    /// \return	the number of driving rows per run, 0 for all.
+    [[nodiscard]] size_t getTimeSlice() const noexcept { return m_sliceSize; }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Advance this system's clock by an update's time.
+    /// \param	deltaTime	    the amount of time passed since last update.
+    /// \param	stepTime	    output for the time each run should cover.
+    /// \return	the number of times to run the system for this update.
+    [[nodiscard]] size_t advanceClock(const double deltaTime, double& stepTime) noexcept;
 
     ///////////////////////////////////////////////////////////////////////////
     /// \brief  Tick this system by deltaTime.
@@ -61,13 +118,56 @@ class ecsSystem {
     /// \brief  Add a component type to be used by this system.
     /// \param	componentType	the type of component to use
     /// \param	componentFlag	flag indicating required/optional.
+    /// \param	written			true if runs write the type, marking its rows changed.
     void addComponentType(
-        const ComponentID componentType, const RequirementsFlag componentFlag = RequirementsFlag::REQUIRED);
+        const ComponentID componentType, const RequirementsFlag componentFlag = RequirementsFlag::REQUIRED,
+        const bool written = false);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Add a world singleton type required by this system.
+    /// \note   Singletons are resolved once per update rather than per entity,
+    ///         the system is skipped if any of them are missing.
+    /// \param	componentType	the type of singleton to use.
+    void addSingletonType(const ComponentID componentType);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve a singleton resolved for the current update.
+    /// \tparam	Component       the class type of singleton.
+    /// \return	the singleton on success, nullptr otherwise.
+    template <typename Component>[[nodiscard]] Component* getSingleton() const noexcept {
+        const auto count = std::min(m_singletonTypes.size(), m_singletons.size());
+        for (size_t i = 0; i < count; ++i) {
+            if (m_singletonTypes[i] == Component::Runtime_ID) {
+                return static_cast<Component*>(m_singletons[i]);
+            }
+        }
+        return nullptr;
+    }
 
     private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Where a time-sliced system resumes its query.
+    struct SliceCursor {
+        ComponentID m_driverID = -1;   ///< The component class driving the query, -1 for entities.
+        size_t m_index = 0ULL;         ///< The next driving row to visit, or entities scanned this pass.
+        EntityHandle m_entityHandle{}; ///< The entity at the next driving row, or the next to scan.
+    };
+
     ///////////////////////////////////////////////////////////////////////////
     /// Private Attributes
+    size_t m_updateInterval = 1ULL;                                         ///< Updates per run.
+    size_t m_tickCount = 0ULL;                                              ///< Updates since last run.
+    double m_fixedTimestep = 0.0;                                           ///< Fixed step length, if any.
+    size_t m_maxSteps = 8ULL;                                               ///< Most fixed steps per update.
+    double m_elapsedTime = 0.0;                                             ///< Time not yet consumed.
+    size_t m_sliceSize = 0ULL;                                              ///< Driving rows per run, if any.
+    SliceCursor m_cursor;                                                   ///< Time-slice resume point.
     std::vector<std::pair<ComponentID, RequirementsFlag>> m_componentTypes; ///< Required component types.
+    std::vector<ComponentID> m_writtenTypes;                                ///< Types marked changed after runs.
+    std::vector<ComponentID> m_singletonTypes;                              ///< Required singleton types.
+    std::vector<ecsBaseComponent*> m_singletons;                            ///< Singletons for this update.
+    uint64_t m_lastRunTick = 0ULL;                                          ///< World tick of the last run.
+    uint64_t m_passStartTick = 0ULL;                                        ///< Last run before this slice pass.
+    uint64_t m_passSinceTick = 0ULL;                                        ///< Last run before the prior pass.
+    friend class ecsWorld;                                                  ///< Allows the ecsWorld to access.
 };
 
 ///////////////////////////////////////////////////////////////////////////
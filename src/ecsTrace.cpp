@@ -0,0 +1,580 @@
+#include "ecsTrace.hpp"
+#include "ecsWorld.hpp"
+#include <fstream>
+#include <iterator>
+
+///////////////////////////////////////////////////////////////////////////
+/// Use our shared namespace mini
+using namespace mini;
+
+///////////////////////////////////////////////////////////////////////////
+/// Every trace begins with this tag, its last byte being the format version
+constexpr uint8_t TraceHeader[] = { 'M', 'E', 'C', 'S', 'T', 'R', 'C', 1U };
+
+///////////////////////////////////////////////////////////////////////////
+/// Described classes larger than this are rejected as malformed
+constexpr size_t MaxTypeSize = 1ULL << 20U;
+
+///////////////////////////////////////////////////////////////////////////
+/// \class  StandInComponent
+/// \brief  The header of a replayed component, its payload left zeroed.
+struct StandInComponent final : ecsBaseComponent {};
+
+///////////////////////////////////////////////////////////////////////////
+/// save
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsTraceRecorder::save(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    return static_cast<bool>(
+        file.write(reinterpret_cast<const char*>(m_data.data()), static_cast<std::streamsize>(m_data.size())));
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// clear
+///////////////////////////////////////////////////////////////////////////
+
+void ecsTraceRecorder::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_data.assign(std::cbegin(TraceHeader), std::cend(TraceHeader));
+    m_operationCount = 0ULL;
+    m_entityIndices.clear();
+    m_sharedIndices.clear();
+    m_describedTypes.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// recordEntity
+///////////////////////////////////////////////////////////////////////////
+
+void ecsTraceRecorder::recordEntity(const Operation operation, const EntityHandle& entityHandle) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    beginOperation(operation);
+    writeEntity(entityHandle);
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// recordType
+///////////////////////////////////////////////////////////////////////////
+
+void ecsTraceRecorder::recordType(
+    const Operation operation, const EntityHandle& entityHandle, const ComponentID componentID, const bool value) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    describeType(componentID);
+    beginOperation(operation);
+    writeEntity(entityHandle);
+    writeVarint(static_cast<uint64_t>(componentID));
+    if (operation == Operation::SET_TAG) {
+        m_data.emplace_back(static_cast<uint8_t>(value));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// recordEnabled
+///////////////////////////////////////////////////////////////////////////
+
+void ecsTraceRecorder::recordEnabled(const EntityHandle& entityHandle, const bool enabled) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    beginOperation(Operation::SET_ENABLED);
+    writeEntity(entityHandle);
+    m_data.emplace_back(static_cast<uint8_t>(enabled));
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// recordParent
+///////////////////////////////////////////////////////////////////////////
+
+void ecsTraceRecorder::recordParent(const EntityHandle& entityHandle, const EntityHandle& parentHandle) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    beginOperation(Operation::SET_PARENT);
+    writeEntity(entityHandle);
+    writeEntity(parentHandle);
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// recordGroup
+///////////////////////////////////////////////////////////////////////////
+
+void ecsTraceRecorder::recordGroup(const std::vector<ComponentID>& componentIDs) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& componentID : componentIDs) {
+        describeType(componentID);
+    }
+    beginOperation(Operation::MAKE_GROUP);
+    writeVarint(componentIDs.size());
+    for (const auto& componentID : componentIDs) {
+        writeVarint(static_cast<uint64_t>(componentID));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// recordQuery
+///////////////////////////////////////////////////////////////////////////
+
+void ecsTraceRecorder::recordQuery(
+    const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& [componentID, componentFlag] : componentTypes) {
+        describeType(componentID);
+    }
+    beginOperation(Operation::QUERY);
+    writeVarint(componentTypes.size());
+    for (const auto& [componentID, componentFlag] : componentTypes) {
+        writeVarint(static_cast<uint64_t>(componentID));
+        m_data.emplace_back(static_cast<uint8_t>(componentFlag));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// recordClass
+///////////////////////////////////////////////////////////////////////////
+
+void ecsTraceRecorder::recordClass(const Operation operation, const ComponentID componentID, const bool value) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    describeType(componentID);
+    beginOperation(operation);
+    writeVarint(static_cast<uint64_t>(componentID));
+    if (operation == Operation::SET_DOUBLE_BUFFERED) {
+        m_data.emplace_back(static_cast<uint8_t>(value));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// recordShared
+///////////////////////////////////////////////////////////////////////////
+
+void ecsTraceRecorder::recordShared(
+    const Operation operation, const EntityHandle& entityHandle, const ComponentHandle& sharedHandle,
+    const ComponentID componentID) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (operation == Operation::MAKE_SHARED) {
+        describeType(componentID);
+    }
+    beginOperation(operation);
+    if (operation == Operation::SET_SHARED) {
+        writeEntity(entityHandle);
+    }
+    writeShared(sharedHandle);
+    if (operation == Operation::MAKE_SHARED) {
+        writeVarint(static_cast<uint64_t>(componentID));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// recordValue
+///////////////////////////////////////////////////////////////////////////
+
+void ecsTraceRecorder::recordValue(const Operation operation, const uint64_t value) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    beginOperation(operation);
+    writeVarint(value);
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// recordOperation
+///////////////////////////////////////////////////////////////////////////
+
+void ecsTraceRecorder::recordOperation(const Operation operation) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    beginOperation(operation);
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// beginOperation
+///////////////////////////////////////////////////////////////////////////
+
+void ecsTraceRecorder::beginOperation(const Operation operation) {
+    m_data.emplace_back(static_cast<uint8_t>(operation));
+    ++m_operationCount;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// writeEntity
+///////////////////////////////////////////////////////////////////////////
+
+void ecsTraceRecorder::writeEntity(const EntityHandle& entityHandle) {
+    if (!entityHandle.isValid()) {
+        writeVarint(0ULL);
+        return;
+    }
+
+    // Numbers start at one, leaving zero for the empty handle
+    const auto [position, inserted] = m_entityIndices.try_emplace(entityHandle, m_entityIndices.size() + 1ULL);
+    writeVarint(position->second);
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// writeShared
+///////////////////////////////////////////////////////////////////////////
+
+void ecsTraceRecorder::writeShared(const ComponentHandle& sharedHandle) {
+    if (!sharedHandle.isValid()) {
+        writeVarint(0ULL);
+        return;
+    }
+
+    const auto [position, inserted] = m_sharedIndices.try_emplace(sharedHandle, m_sharedIndices.size() + 1ULL);
+    writeVarint(position->second);
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// describeType
+///////////////////////////////////////////////////////////////////////////
+
+void ecsTraceRecorder::describeType(const ComponentID componentID) {
+    const auto index = static_cast<size_t>(componentID);
+    if (index < m_describedTypes.size() && m_describedTypes[index]) {
+        return;
+    }
+    if (index >= m_describedTypes.size()) {
+        m_describedTypes.resize(index + 1ULL, false);
+    }
+    m_describedTypes[index] = true;
+
+    // Descriptions aren't counted, as they're replayed for free
+    m_data.emplace_back(static_cast<uint8_t>(Operation::DESCRIBE_TYPE));
+    writeVarint(index);
+    writeVarint(std::get<2>(ecsBaseComponent::m_componentRegistry[index]));
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// writeVarint
+///////////////////////////////////////////////////////////////////////////
+
+void ecsTraceRecorder::writeVarint(uint64_t value) {
+    while (value >= 0x80ULL) {
+        m_data.emplace_back(static_cast<uint8_t>(value | 0x80ULL));
+        value >>= 7U;
+    }
+    m_data.emplace_back(static_cast<uint8_t>(value));
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// load
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsTraceReplayer::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    return load(std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsTraceReplayer::load(std::vector<uint8_t> data) {
+    if (data.size() < sizeof(TraceHeader) ||
+        !std::equal(std::cbegin(TraceHeader), std::cend(TraceHeader), data.cbegin())) {
+        return false;
+    }
+
+    m_data = std::move(data);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// replay
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsTraceReplayer::replay(ecsWorld& world) {
+    m_entities.clear();
+    m_sharedValues.clear();
+    m_operationCount = 0ULL;
+    m_queryRowCount = 0ULL;
+    if (m_data.empty()) {
+        return false;
+    }
+
+    // Reads stop at the end of the trace, flagging it as malformed
+    auto cursor = sizeof(TraceHeader);
+    bool malformed = false;
+    const auto readByte = [&]() -> uint8_t {
+        if (cursor >= m_data.size()) {
+            malformed = true;
+            return 0U;
+        }
+        return m_data[cursor++];
+    };
+    const auto readVarint = [&]() {
+        uint64_t value(0ULL);
+        for (uint32_t shift = 0U; shift < 64U; shift += 7U) {
+            const auto byte = readByte();
+            value |= static_cast<uint64_t>(byte & 0x7FU) << shift;
+            if ((byte & 0x80U) == 0U) {
+                break;
+            }
+        }
+        return value;
+    };
+    // Recorded numbers are handed out in order, so each is at most one past those already seen
+    const auto readIndex = [&](auto& handles) {
+        const auto index = readVarint();
+        if (index > handles.size() + 1ULL) {
+            malformed = true;
+            return uint64_t(0ULL);
+        }
+        if (index > handles.size()) {
+            handles.emplace_back();
+        }
+        return index;
+    };
+    const auto readEntity = [&]() {
+        const auto index = readIndex(m_entities);
+        return index == 0ULL ? EntityHandle() : m_entities[index - 1ULL];
+    };
+    const auto readShared = [&]() {
+        const auto index = readIndex(m_sharedValues);
+        return index == 0ULL ? ComponentHandle() : m_sharedValues[index - 1ULL];
+    };
+    const auto readCount = [&](const size_t elementSize) {
+        const auto count = readVarint();
+        if (count > (m_data.size() - cursor) / elementSize) {
+            malformed = true;
+            return size_t(0ULL);
+        }
+        return static_cast<size_t>(count);
+    };
+    const auto readType = [&]() {
+        const auto position = m_typeIDs.find(readVarint());
+        if (position == m_typeIDs.end()) {
+            malformed = true;
+            return ComponentID(0);
+        }
+        return position->second;
+    };
+
+    using Operation = ecsTraceRecorder::Operation;
+    std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>> componentTypes;
+    std::vector<ComponentID> componentIDs;
+    while (cursor < m_data.size() && !malformed) {
+        const auto operation = static_cast<Operation>(readByte());
+        if (operation == Operation::DESCRIBE_TYPE) {
+            const auto recordedID = readVarint();
+            const auto size = readVarint();
+            malformed = malformed || size > MaxTypeSize;
+            if (!malformed) {
+                describeType(recordedID, static_cast<size_t>(size));
+            }
+            continue;
+        }
+
+        switch (operation) {
+        case Operation::MAKE_ENTITY: {
+            const auto index = readIndex(m_entities);
+            if (index == 0ULL) {
+                malformed = true;
+                break;
+            }
+            m_entities[index - 1ULL] = world.makeEntity();
+            break;
+        }
+        case Operation::REMOVE_ENTITY:
+            world.removeEntity(readEntity());
+            break;
+        case Operation::MAKE_COMPONENT: {
+            const auto entityHandle = readEntity();
+            const auto componentID = readType();
+            if (!malformed) {
+                [[maybe_unused]] const auto componentHandle = world.makeComponentInternal(
+                    entityHandle, componentID,
+                    reinterpret_cast<const ecsBaseComponent*>(m_prototypes[componentID].data()));
+            }
+            break;
+        }
+        case Operation::REMOVE_COMPONENT: {
+            const auto entityHandle = readEntity();
+            const auto componentID = readType();
+            if (!malformed) {
+                world.removeComponentInternal(entityHandle, componentID);
+            }
+            break;
+        }
+        case Operation::SET_TAG: {
+            const auto entityHandle = readEntity();
+            const auto componentID = readType();
+            const auto value = readByte() != 0U;
+            if (!malformed) {
+                world.setTagInternal(entityHandle, componentID, value);
+            }
+            break;
+        }
+        case Operation::SET_ENABLED: {
+            const auto entityHandle = readEntity();
+            world.setEnabled(entityHandle, readByte() != 0U);
+            break;
+        }
+        case Operation::SET_PARENT: {
+            const auto entityHandle = readEntity();
+            world.setParent(entityHandle, readEntity());
+            break;
+        }
+        case Operation::MAKE_GROUP: {
+            componentIDs.resize(readCount(1ULL));
+            for (auto& componentID : componentIDs) {
+                componentID = readType();
+            }
+            if (!malformed) {
+                world.makeGroup(componentIDs);
+            }
+            break;
+        }
+        case Operation::QUERY: {
+            componentTypes.resize(readCount(2ULL));
+            for (auto& [componentID, componentFlag] : componentTypes) {
+                componentID = readType();
+                const auto flag = readByte();
+                malformed = malformed || flag > static_cast<uint8_t>(ecsSystem::RequirementsFlag::ADDED);
+                componentFlag = static_cast<ecsSystem::RequirementsFlag>(flag);
+            }
+            if (!malformed) {
+                m_queryRowCount += world.getRelevantComponents(componentTypes).size();
+            }
+            break;
+        }
+        case Operation::FLIP_BUFFERS:
+            world.flipBuffers();
+            break;
+        case Operation::CLEAR:
+            world.clear();
+            break;
+        case Operation::SET_TOMBSTONE_MODE:
+            world.setTombstoneMode(readVarint() != 0ULL);
+            break;
+        case Operation::COMPACT:
+            world.compactComponents(static_cast<size_t>(readVarint()));
+            break;
+        case Operation::MARK_CHANGED: {
+            // Components without an entity are singletons
+            const auto entityHandle = readEntity();
+            const auto componentID = readType();
+            if (malformed) {
+                break;
+            }
+            auto* component = entityHandle.isValid() ? world.getComponentInternal(entityHandle, componentID)
+                                                     : world.getSingletonInternal(componentID);
+            if (component != nullptr) {
+                world.markChanged(*component);
+            }
+            break;
+        }
+        case Operation::SORT_HIERARCHY: {
+            const auto componentID = readType();
+            if (!malformed) {
+                world.sortHierarchy(componentID);
+            }
+            break;
+        }
+        case Operation::MAKE_SINGLETON: {
+            const auto componentID = readType();
+            if (!malformed) {
+                world.makeSingletonInternal(
+                    componentID, reinterpret_cast<const ecsBaseComponent*>(m_prototypes[componentID].data()));
+            }
+            break;
+        }
+        case Operation::REMOVE_SINGLETON: {
+            const auto componentID = readType();
+            if (!malformed) {
+                world.removeSingletonInternal(componentID);
+            }
+            break;
+        }
+        case Operation::MAKE_SHARED: {
+            const auto index = readIndex(m_sharedValues);
+            const auto componentID = readType();
+            if (index == 0ULL) {
+                malformed = true;
+            }
+            if (!malformed) {
+                m_sharedValues[index - 1ULL] = world.makeSharedComponentInternal(
+                    componentID, reinterpret_cast<const ecsBaseComponent*>(m_prototypes[componentID].data()));
+            }
+            break;
+        }
+        case Operation::REMOVE_SHARED:
+            world.removeSharedComponent(readShared());
+            break;
+        case Operation::SET_SHARED: {
+            const auto entityHandle = readEntity();
+            world.setSharedComponent(entityHandle, readShared());
+            break;
+        }
+        case Operation::UNSET_SHARED: {
+            const auto entityHandle = readEntity();
+            const auto componentID = readType();
+            if (!malformed) {
+                world.unsetSharedComponentInternal(entityHandle, componentID);
+            }
+            break;
+        }
+        case Operation::SET_DOUBLE_BUFFERED: {
+            const auto componentID = readType();
+            const auto value = readByte() != 0U;
+            if (!malformed) {
+                world.setDoubleBuffered(componentID, value);
+            }
+            break;
+        }
+        case Operation::FLIP_EVENTS:
+            world.flipEvents();
+            break;
+        default:
+            malformed = true;
+            break;
+        }
+        ++m_operationCount;
+    }
+    return !malformed;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// describeType
+///////////////////////////////////////////////////////////////////////////
+
+void ecsTraceReplayer::describeType(const uint64_t recordedID, const size_t size) {
+    // Stand-ins are registered once, so repeated replays share their classes
+    if (m_typeIDs.find(recordedID) != m_typeIDs.end()) {
+        return;
+    }
+
+    // Other replayers' stand-ins of the same size are claimed before registering more
+    const auto typeSize = size == 0ULL ? 0ULL : std::max(size, sizeof(StandInComponent));
+    auto& standIns = m_standIns[typeSize];
+    const auto claimed = m_claimedStandIns[typeSize]++;
+    if (claimed == standIns.size()) {
+        standIns.emplace_back(
+            typeSize == 0ULL ? ecsBaseComponent::registerType(nullptr, nullptr, 0ULL)
+                             : ecsBaseComponent::registerType(&createStandIn, nullptr, typeSize, true));
+    }
+    const auto componentID = standIns[claimed];
+    m_typeIDs[recordedID] = componentID;
+    if (typeSize == 0ULL) {
+        return;
+    }
+
+    auto& prototype = m_prototypes[componentID];
+    prototype.resize(typeSize, 0U);
+    auto* component = new (prototype.data()) StandInComponent();
+    component->m_runtimeID = componentID;
+    component->m_size = typeSize;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// createStandIn
+///////////////////////////////////////////////////////////////////////////
+
+ComponentIndex ecsTraceReplayer::createStandIn(
+    ComponentDataSpace& memory, const ComponentHandle& componentHandle, const EntityHandle& entityHandle,
+    const ecsBaseComponent* component) {
+    const auto index = memory.size();
+    const auto row = toComponentIndex(index / component->m_size);
+    memory.resize(index + component->m_size);
+    std::memcpy(static_cast<void*>(&memory[index]), static_cast<const void*>(component), component->m_size);
+    auto* clone = reinterpret_cast<ecsBaseComponent*>(&memory[index]);
+    clone->m_handle = componentHandle;
+    clone->m_entityHandle = entityHandle;
+    return row;
+}
\ No newline at end of file
@@ -0,0 +1,231 @@
+#pragma once
+#ifndef MINIECS_ECSTRACE_HPP
+#define MINIECS_ECSTRACE_HPP
+
+#include "ecsComponent.hpp"
+#include "ecsHandle.hpp"
+#include "ecsSystem.hpp"
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mini {
+///////////////////////////////////////////////////////////////////////////
+/// Forward Declarations
+class ecsWorld;
+
+///////////////////////////////////////////////////////////////////////////
+/// \class  ecsTraceRecorder
+/// \brief  Logs the mutations and queries made to an ecsWorld as a compact
+///         binary trace, for replaying later with an ecsTraceReplayer.
+/// \note   Entities are numbered in order of appearance and each component
+///         class is described once, so traces don't depend on handles or on
+///         the recording program's types. Component values aren't recorded.
+class ecsTraceRecorder final {
+    public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  The kinds of operation found in a trace.
+    enum class Operation : uint8_t {
+        DESCRIBE_TYPE,
+        MAKE_ENTITY,
+        REMOVE_ENTITY,
+        MAKE_COMPONENT,
+        REMOVE_COMPONENT,
+        SET_TAG,
+        SET_ENABLED,
+        SET_PARENT,
+        MAKE_GROUP,
+        QUERY,
+        FLIP_BUFFERS,
+        CLEAR,
+        SET_TOMBSTONE_MODE,
+        COMPACT,
+        MARK_CHANGED,
+        SORT_HIERARCHY,
+        MAKE_SINGLETON,
+        REMOVE_SINGLETON,
+        MAKE_SHARED,
+        REMOVE_SHARED,
+        SET_SHARED,
+        UNSET_SHARED,
+        SET_DOUBLE_BUFFERED,
+        FLIP_EVENTS,
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Construct an empty trace.
+    ecsTraceRecorder() { clear(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the trace recorded so far.
+    /// \return	the trace's bytes.
+    [[nodiscard]] const std::vector<uint8_t>& getData() const noexcept { return m_data; }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the number of operations recorded so far.
+    /// \return	the number of operations.
+    [[nodiscard]] size_t getOperationCount() const noexcept { return m_operationCount; }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Write the trace recorded so far to a file.
+    /// \param	path				the file to write.
+    /// \return	true on success, false otherwise.
+    bool save(const std::string& path) const;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Discard everything recorded.
+    void clear();
+
+    private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Record an operation on an entity.
+    /// \param	operation			MAKE_ENTITY or REMOVE_ENTITY.
+    /// \param	entityHandle		handle to the entity.
+    void recordEntity(const Operation operation, const EntityHandle& entityHandle);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Record an operation on one type of an entity.
+    /// \param	operation			MAKE_COMPONENT, REMOVE_COMPONENT, SET_TAG, MARK_CHANGED or UNSET_SHARED.
+    /// \param	entityHandle		handle to the entity.
+    /// \param	componentID			the component or tag class.
+    /// \param	value				the tag's new value, for SET_TAG.
+    void recordType(
+        const Operation operation, const EntityHandle& entityHandle, const ComponentID componentID,
+        const bool value = true);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Record an entity being enabled or disabled.
+    /// \param	entityHandle		handle to the entity.
+    /// \param	enabled				the entity's new state.
+    void recordEnabled(const EntityHandle& entityHandle, const bool enabled);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Record an entity being attached to a new parent.
+    /// \param	entityHandle		handle to the child entity.
+    /// \param	parentHandle		handle to the new parent, empty if detached.
+    void recordParent(const EntityHandle& entityHandle, const EntityHandle& parentHandle);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Record a group being made.
+    /// \param	componentIDs		the grouped component classes.
+    void recordGroup(const std::vector<ComponentID>& componentIDs);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Record a query.
+    /// \param	componentTypes		the component types of the query.
+    void recordQuery(const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Record an operation on a whole class.
+    /// \param	operation			SORT_HIERARCHY, MAKE_SINGLETON, REMOVE_SINGLETON or SET_DOUBLE_BUFFERED.
+    /// \param	componentID			the component class.
+    /// \param	value				the class's new state, for SET_DOUBLE_BUFFERED.
+    void recordClass(const Operation operation, const ComponentID componentID, const bool value = true);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Record an operation on a shared value.
+    /// \param	operation			MAKE_SHARED, REMOVE_SHARED or SET_SHARED.
+    /// \param	entityHandle		handle to the entity sharing the value, for SET_SHARED.
+    /// \param	sharedHandle		handle to the shared value.
+    /// \param	componentID			the shared value's class, for MAKE_SHARED.
+    void recordShared(
+        const Operation operation, const EntityHandle& entityHandle, const ComponentHandle& sharedHandle,
+        const ComponentID componentID = 0);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Record an operation with one numeric operand.
+    /// \param	operation			SET_TOMBSTONE_MODE or COMPACT.
+    /// \param	value				the new tombstone mode, or the compaction's row budget.
+    void recordValue(const Operation operation, const uint64_t value);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Record an operation with no operands.
+    /// \param	operation			FLIP_BUFFERS, CLEAR or FLIP_EVENTS.
+    void recordOperation(const Operation operation);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Begin an operation, the caller must hold the lock.
+    /// \param	operation			the operation to begin.
+    void beginOperation(const Operation operation);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Write an entity's number, numbering it on first sight.
+    /// \param	entityHandle		handle to the entity, empty writes zero.
+    void writeEntity(const EntityHandle& entityHandle);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Write a shared value's number, numbering it on first sight.
+    /// \param	sharedHandle		handle to the shared value, empty writes zero.
+    void writeShared(const ComponentHandle& sharedHandle);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Describe a class on first sight, ahead of the current operation.
+    /// \param	componentID			the component or tag class.
+    void describeType(const ComponentID componentID);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Write an unsigned value in 7-bit groups.
+    /// \param	value				the value to write.
+    void writeVarint(uint64_t value);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    std::vector<uint8_t> m_data;                      ///< The trace recorded so far.
+    size_t m_operationCount = 0ULL;                   ///< Operations recorded so far.
+    std::map<EntityHandle, uint64_t> m_entityIndices;    ///< Number given to each entity seen.
+    std::map<ComponentHandle, uint64_t> m_sharedIndices; ///< Number given to each shared value seen.
+    std::vector<bool> m_describedTypes;                  ///< Classes already described.
+    mutable std::mutex m_mutex;                          ///< Serializes concurrent queries.
+    friend class ecsWorld;                               ///< Allows the ecsWorld to record.
+};
+
+///////////////////////////////////////////////////////////////////////////
+/// \class  ecsTraceReplayer
+/// \brief  Re-runs a recorded trace against an ecsWorld.
+/// \note   Recorded classes are replaced by stand-in classes of the same
+///         byte-size, so any trace can be replayed without its original types.
+class ecsTraceReplayer final {
+    public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Load a trace from a file.
+    /// \param	path				the file to read.
+    /// \return	true on success, false otherwise.
+    bool load(const std::string& path);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Load a trace from memory.
+    /// \param	data				the trace's bytes.
+    /// \return	true if the data is a trace, false otherwise.
+    bool load(std::vector<uint8_t> data);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Apply every operation of the loaded trace to a world.
+    /// \param	world				the world to replay into.
+    /// \return	true on success, false if the trace is malformed.
+    bool replay(ecsWorld& world);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the number of operations applied by the last replay.
+    /// \return	the number of operations.
+    [[nodiscard]] size_t getOperationCount() const noexcept { return m_operationCount; }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the number of rows the last replay's queries produced.
+    /// \return	the number of rows.
+    [[nodiscard]] size_t getQueryRowCount() const noexcept { return m_queryRowCount; }
+
+    private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Register a stand-in for a recorded class.
+    /// \param	recordedID			the class ID in the trace.
+    /// \param	size				the class's byte-size, zero for tags.
+    void describeType(const uint64_t recordedID, const size_t size);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Copy a stand-in component into a component pool.
+    /// \param	memory				the pool to copy into.
+    /// \param	componentHandle		handle to the new component.
+    /// \param	entityHandle		handle to the component's parent entity.
+    /// \param	component			the stand-in to copy, which can't be null.
+    /// \return	the element index of the new component.
+    static ComponentIndex createStandIn(
+        ComponentDataSpace& memory, const ComponentHandle& componentHandle, const EntityHandle& entityHandle,
+        const ecsBaseComponent* component);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    std::vector<uint8_t> m_data;                            ///< The loaded trace.
+    std::map<uint64_t, ComponentID> m_typeIDs;              ///< Stand-in class for each recorded class.
+    std::map<ComponentID, ComponentDataSpace> m_prototypes; ///< Stand-in component to copy, per class.
+    std::map<size_t, size_t> m_claimedStandIns;             ///< Stand-ins claimed, per byte-size.
+    std::vector<EntityHandle> m_entities;                   ///< Replayed entity for each recorded number.
+    std::vector<ComponentHandle> m_sharedValues;            ///< Replayed shared value for each recorded number.
+    size_t m_operationCount = 0ULL;                         ///< Operations applied by the last replay.
+    size_t m_queryRowCount = 0ULL;                          ///< Rows produced by the last replay's queries.
+    inline static std::map<size_t, std::vector<ComponentID>>
+        m_standIns = {};                                    ///< Stand-ins registered by every replayer, per byte-size.
+};
+};     // namespace mini
+#endif // MINIECS_ECSTRACE_HPP
\ No newline at end of file
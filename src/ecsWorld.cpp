@@ -1,6 +1,8 @@
 #include "ecsWorld.hpp"
+#include <algorithm>
+#include <atomic>
 #include <random>
-#include <sstream>
+#include <utility>
 
 ///////////////////////////////////////////////////////////////////////////
 /// Use our shared namespace mini
@@ -11,10 +13,12 @@ using namespace mini;
 ///////////////////////////////////////////////////////////////////////////
 
 EntityHandle ecsWorld::makeEntity(const ecsBaseComponent* const* const components, const size_t numComponents) {
+    assertWritable();
+
     auto UUID = EntityHandle(generateUUID());
 
     // Insert and retrieve the new entity's reference
-    auto& entity = *m_entities.insert_or_assign(UUID, std::make_shared<ecsEntity>(ecsEntity{ UUID, {} })).first->second;
+    auto& entity = insertEntity(ecsEntity{ UUID, {}, {} });
 
     // Insert all components directly into the entity
     for (size_t i = 0; i < numComponents; ++i) {
@@ -54,14 +58,45 @@ bool ecsWorld::removeEntity(const EntityHandle& entityHandle) {
 ///////////////////////////////////////////////////////////////////////////
 
 bool mini::ecsWorld::removeEntity(ecsEntity& entity) {
+    // Delete the subtree in a single batch, deepest entities first
+    detachFromParent(entity);
+    const auto subtree = getSubtree(entity);
+    for (auto member = subtree.crbegin(); member != subtree.crend(); ++member) {
+        removeEntityInternal(**member);
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// removeEntityInternal
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::removeEntityInternal(ecsEntity& entity) {
+    assertWritable();
+
+    recordRemoved(entity);
+    if (m_recorder != nullptr) {
+        m_recorder->recordEntity(ecsTraceRecorder::Operation::REMOVE_ENTITY, entity.m_handle);
+    }
+
+    // Release this entity's group slots before its components are moved
+    for (auto& group : m_groups) {
+        removeFromGroup(entity, group);
+    }
+
     // Delete this entity's components
-    for (auto& [id, createFn, componentHandle] : entity.m_components) {
-        removeComponentInternal(id, createFn);
+    for (auto& [id, index, componentHandle] : entity.m_components) {
+        removeComponentInternal(id, index);
     }
 
     // Delete this entity
+    if (const auto count = m_census.find(entity.m_signature); count != m_census.end()) {
+        --count->second;
+    }
+    for (const auto& [id, index, componentHandle] : entity.m_components) {
+        refreshPlans(id);
+    }
     m_entities.erase(entity.m_handle);
-    return true;
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -78,6 +113,152 @@ bool ecsWorld::removeComponent(const ComponentHandle& componentHandle) {
     return removeComponentInternal(component->m_entityHandle, component->m_runtimeID);
 }
 
+///////////////////////////////////////////////////////////////////////////
+/// setTombstoneMode
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::setTombstoneMode(const bool enabled) {
+    assertWritable();
+
+    if (m_recorder != nullptr) {
+        m_recorder->recordValue(ecsTraceRecorder::Operation::SET_TOMBSTONE_MODE, enabled ? 1ULL : 0ULL);
+    }
+
+    // Swapping removals assume every row is live
+    m_tombstoneMode = enabled;
+    if (!enabled) {
+        compactComponents();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// getTombstoneCount
+///////////////////////////////////////////////////////////////////////////
+
+size_t ecsWorld::getTombstoneCount() const noexcept {
+    size_t count(0ULL);
+    for (const auto& [componentID, tombstones] : m_tombstones) {
+        count += tombstones.m_count;
+    }
+    return count;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// compactComponents
+///////////////////////////////////////////////////////////////////////////
+
+size_t ecsWorld::compactComponents(const size_t rowBudget) {
+    assertWritable();
+
+    if (m_recorder != nullptr) {
+        m_recorder->recordValue(ecsTraceRecorder::Operation::COMPACT, rowBudget);
+    }
+
+    // Resume after the last pool compacted, wrapping around
+    size_t reclaimed(0ULL);
+    size_t visited(0ULL);
+    while (!m_tombstones.empty() && (visited == 0ULL || visited < rowBudget)) {
+        auto next = m_tombstones.lower_bound(m_compactionCursor);
+        if (next == m_tombstones.end()) {
+            next = m_tombstones.begin();
+        }
+        const auto componentID = next->first;
+        visited += std::max<size_t>(
+            1ULL, findPool(componentID)->size() / std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]));
+        reclaimed += compactPool(componentID);
+        m_compactionCursor = componentID + 1;
+    }
+    return reclaimed;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// markChanged
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::markChanged(ecsBaseComponent& component) {
+    if (m_recorder != nullptr) {
+        m_recorder->recordType(
+            ecsTraceRecorder::Operation::MARK_CHANGED, component.m_entityHandle, component.m_runtimeID);
+    }
+    stampChanged(component);
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// stampChanged
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::stampChanged(ecsBaseComponent& component) {
+    // Pooled rows also raise their chunk's summary, found from the row's address
+    component.m_changedTick = m_changeTick;
+    if (isPooled(component.m_runtimeID)) {
+        const auto* mem_array = findPool(component.m_runtimeID);
+        raiseChunkTick(
+            component.m_runtimeID,
+            static_cast<size_t>(reinterpret_cast<const uint8_t*>(&component) - mem_array->data()), m_changeTick);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// setEnabled
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsWorld::setEnabled(const EntityHandle& entityHandle, const bool enabled) {
+    const auto entity = getEntity(entityHandle);
+    if (entity == nullptr) {
+        return false;
+    }
+
+    return setEnabled(*entity, enabled);
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+bool mini::ecsWorld::setEnabled(ecsEntity& entity, const bool enabled) {
+    assertWritable();
+
+    if (entity.m_enabled == enabled) {
+        return true;
+    }
+
+    // Groups only hold enabled entities, so leave them before going cold
+    if (!enabled) {
+        for (auto& group : m_groups) {
+            removeFromGroup(entity, group);
+        }
+    }
+
+    if (m_recorder != nullptr) {
+        m_recorder->recordEnabled(entity.m_handle, enabled);
+    }
+
+    // Swap each row across the boundary between the active range and the tail
+    entity.m_enabled = enabled;
+    for (const auto& [componentID, index, componentHandle] : entity.m_components) {
+        if (enabled) {
+            activateRow(componentID, getByteOffset(componentID, index));
+        } else {
+            deactivateRow(componentID, getByteOffset(componentID, index));
+        }
+        refreshPlans(componentID);
+    }
+
+    if (enabled) {
+        for (auto& group : m_groups) {
+            addToGroup(entity, group);
+        }
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// isEnabled
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsWorld::isEnabled(const EntityHandle& entityHandle) const {
+    const auto* entity = findEntity(entityHandle);
+    return entity != nullptr && entity->m_enabled;
+}
+
 ///////////////////////////////////////////////////////////////////////////
 /// getEntity
 ///////////////////////////////////////////////////////////////////////////
@@ -111,11 +292,47 @@ std::vector<std::shared_ptr<ecsEntity>> ecsWorld::getEntities(const std::vector<
     return entities;
 }
 
+///////////////////////////////////////////////////////////////////////////
+/// getResidency
+///////////////////////////////////////////////////////////////////////////
+
+ecsWorld::Residency ecsWorld::getResidency(const EntityHandle& entityHandle) const {
+    if (findEntity(entityHandle) != nullptr) {
+        return Residency::RESIDENT;
+    }
+    return m_evicted.find(entityHandle) != m_evicted.cend() ? Residency::EVICTED : Residency::UNKNOWN;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// findEntity
+///////////////////////////////////////////////////////////////////////////
+
+ecsEntity* ecsWorld::findEntity(const EntityHandle& UUID) const noexcept {
+    const auto pos = m_entities.find(UUID);
+    return pos == m_entities.end() ? nullptr : pos->second.get();
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// findPool
+///////////////////////////////////////////////////////////////////////////
+
+ComponentDataSpace* ecsWorld::findPool(const ComponentID componentID) const noexcept {
+    // Pools are only ever modified through non-const members
+    const auto pos = m_components.find(componentID);
+    return pos == m_components.end() ? nullptr : const_cast<ComponentDataSpace*>(&pos->second);
+}
+
 ///////////////////////////////////////////////////////////////////////////
 /// getComponent
 ///////////////////////////////////////////////////////////////////////////
 
 ecsBaseComponent* ecsWorld::getComponent(const ComponentHandle& componentHandle) {
+    return const_cast<ecsBaseComponent*>(std::as_const(*this).getComponent(componentHandle));
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+const ecsBaseComponent* ecsWorld::getComponent(const ComponentHandle& componentHandle) const {
     if (!componentHandle.isValid()) {
         return nullptr;
     }
@@ -125,7 +342,7 @@ ecsBaseComponent* ecsWorld::getComponent(const ComponentHandle& componentHandle)
         // Check if this entity contains the component handle
         for (const auto& [compID, fn, compHandle] : entity->m_components) {
             if (compHandle == componentHandle) {
-                return reinterpret_cast<ecsBaseComponent*>(&(m_components[compID].at(fn)));
+                return locateComponent(compID, fn);
             }
         }
     }
@@ -140,11 +357,144 @@ ecsBaseComponent* ecsWorld::getComponent(const ComponentHandle& componentHandle)
 ecsWorld& ecsWorld::operator=(ecsWorld&& other) noexcept {
     if (this != &other) {
         m_components = std::move(other.m_components);
+        m_stores = std::move(other.m_stores);
         m_entities = std::move(other.m_entities);
+        m_groups = std::move(other.m_groups);
+        m_singletons = std::move(other.m_singletons);
+        m_sharedComponents = std::move(other.m_sharedComponents);
+        m_observers = std::move(other.m_observers);
+        m_bufferedTypes = std::move(other.m_bufferedTypes);
+        m_snapshots = std::move(other.m_snapshots);
+        m_frontSnapshot = other.m_frontSnapshot;
+        m_flipCount = other.m_flipCount;
+        m_disabledCounts = std::move(other.m_disabledCounts);
+        m_tombstones = std::move(other.m_tombstones);
+        m_tombstoneMode = other.m_tombstoneMode;
+        m_compactionCursor = other.m_compactionCursor;
+        m_chunkTicks = std::move(other.m_chunkTicks);
+        m_changeTick = other.m_changeTick;
+        m_structuralVersions = std::move(other.m_structuralVersions);
+        bumpStructuralVersions();
+        m_evicted = std::move(other.m_evicted);
+        m_census = std::move(other.m_census);
+        m_plans = std::move(other.m_plans);
+        m_plannedRows = std::move(other.m_plannedRows);
+        m_plannedEntities = other.m_plannedEntities;
+        m_eventChannels = std::move(other.m_eventChannels);
+        m_recorder = std::exchange(other.m_recorder, nullptr);
     }
     return *this;
 }
 
+///////////////////////////////////////////////////////////////////////////
+/// makeSingleton
+///////////////////////////////////////////////////////////////////////////
+
+ecsBaseComponent* ecsWorld::makeSingleton(const ecsBaseComponent* const component) {
+    return makeSingletonInternal(component->m_runtimeID, component);
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// makeSharedComponent
+///////////////////////////////////////////////////////////////////////////
+
+ComponentHandle ecsWorld::makeSharedComponent(const ecsBaseComponent* const component) {
+    return makeSharedComponentInternal(component->m_runtimeID, component);
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// removeSharedComponent
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsWorld::removeSharedComponent(const ComponentHandle& sharedHandle) {
+    assertWritable();
+
+    const auto pos = m_sharedComponents.find(sharedHandle);
+    if (pos == m_sharedComponents.end()) {
+        return false;
+    }
+    if (m_recorder != nullptr) {
+        m_recorder->recordShared(ecsTraceRecorder::Operation::REMOVE_SHARED, EntityHandle(), sharedHandle);
+    }
+
+    // Detach the value from every entity referencing it
+    for (auto& [entityHandle, entity] : m_entities) {
+        auto& sharedComponents = entity->m_sharedComponents;
+        sharedComponents.erase(
+            std::remove_if(
+                sharedComponents.begin(), sharedComponents.end(),
+                [&](const auto& shared) { return shared.second == sharedHandle; }),
+            sharedComponents.end());
+    }
+
+    const auto componentID = reinterpret_cast<ecsBaseComponent*>(pos->second.data())->m_runtimeID;
+    freeComponents(componentID, pos->second);
+    m_sharedComponents.erase(pos);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// setSharedComponent
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsWorld::setSharedComponent(const EntityHandle& entityHandle, const ComponentHandle& sharedHandle) {
+    assertWritable();
+
+    const auto entity = getEntity(entityHandle);
+    const auto* shared = getSharedComponentInternal(sharedHandle);
+    if (entity == nullptr || shared == nullptr) {
+        return false;
+    }
+    if (m_recorder != nullptr) {
+        m_recorder->recordShared(ecsTraceRecorder::Operation::SET_SHARED, entityHandle, sharedHandle);
+    }
+
+    // Replace any shared value of the same class
+    for (auto& [componentID, handle] : entity->m_sharedComponents) {
+        if (componentID == shared->m_runtimeID) {
+            handle = sharedHandle;
+            return true;
+        }
+    }
+    entity->m_sharedComponents.emplace_back(shared->m_runtimeID, sharedHandle);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// getSharedPartitions
+///////////////////////////////////////////////////////////////////////////
+
+std::vector<std::pair<ecsBaseComponent*, std::vector<std::vector<ecsBaseComponent*>>>> ecsWorld::getSharedPartitions(
+    const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes,
+    const ComponentID sharedID) {
+    std::vector<std::pair<ecsBaseComponent*, std::vector<std::vector<ecsBaseComponent*>>>> partitions;
+    std::map<const ecsBaseComponent*, size_t> partitionIndices;
+
+    for (auto& row : getRelevantComponents(componentTypes)) {
+        // Any component in the row leads back to its entity
+        const auto column =
+            std::find_if(row.cbegin(), row.cend(), [](const auto* component) { return component != nullptr; });
+        if (column == row.cend()) {
+            continue;
+        }
+        const auto entity = getEntity((*column)->m_entityHandle);
+        if (entity == nullptr) {
+            continue;
+        }
+        auto* shared = getSharedComponentInternal(*entity, sharedID);
+        if (shared == nullptr) {
+            continue;
+        }
+
+        const auto [position, inserted] = partitionIndices.try_emplace(shared, partitions.size());
+        if (inserted) {
+            partitions.emplace_back(shared, std::vector<std::vector<ecsBaseComponent*>>{});
+        }
+        partitions[position->second].second.emplace_back(std::move(row));
+    }
+    return partitions;
+}
+
 ///////////////////////////////////////////////////////////////////////////
 /// migrateEntityTo
 ///////////////////////////////////////////////////////////////////////////
@@ -161,16 +511,43 @@ void ecsWorld::migrateEntityTo(const EntityHandle& UUID, ecsWorld& otherWorld) {
 ///////////////////////////////////////////////////////////////////////////
 
 void ecsWorld::migrateEntityTo(ecsEntity& entity, ecsWorld& otherWorld) {
-    // Create a new entity in their world
-    auto& otherEntity =
-        *otherWorld.m_entities
-             .insert_or_assign(entity.m_handle, std::make_shared<ecsEntity>(ecsEntity{ entity.m_handle, {} }))
-             .first->second;
+    // Parents are visited before their children, so links can be rebuilt
+    for (auto* member : getSubtree(entity)) {
+        // Create a new entity in their world, bits are set as its types arrive so observers see it complete last
+        auto& otherEntity = otherWorld.insertEntity(ecsEntity{ member->m_handle });
+        if (member != &entity) {
+            otherEntity.m_parent = otherWorld.m_entities[member->m_parent->m_handle].get();
+            otherEntity.m_parent->m_children.emplace_back(&otherEntity);
+            if (otherWorld.m_recorder != nullptr) {
+                otherWorld.m_recorder->recordParent(member->m_handle, member->m_parent->m_handle);
+            }
+        }
+
+        // Shared values are copied over under the same handle, unless their world already holds them
+        for (const auto& [componentID, sharedHandle] : member->m_sharedComponents) {
+            if (otherWorld.m_sharedComponents.find(sharedHandle) == otherWorld.m_sharedComponents.end()) {
+                const auto& createfn = std::get<0>(ecsBaseComponent::m_componentRegistry[componentID]);
+                createfn(
+                    otherWorld.m_sharedComponents[sharedHandle], sharedHandle, EntityHandle(),
+                    getSharedComponentInternal(sharedHandle));
+            }
+            otherEntity.m_sharedComponents.emplace_back(componentID, sharedHandle);
+        }
 
-    // Copy over the components from our world
-    for (auto& [id, createFn, componentHandle] : entity.m_components) {
-        [[maybe_unused]] const auto newComponentHandle =
-            otherWorld.makeComponent(otherEntity, reinterpret_cast<ecsBaseComponent*>(&m_components[id][createFn]));
+        // Copy over the tags and components from our world
+        for (ComponentID tagID = 0; tagID < static_cast<ComponentID>(ecsBaseComponent::m_componentRegistry.size());
+             ++tagID) {
+            if (isTagID(tagID) && member->m_signature.test(tagID)) {
+                otherWorld.setTagInternal(otherEntity, tagID, true);
+            }
+        }
+        for (auto& [id, index, componentHandle] : member->m_components) {
+            [[maybe_unused]] const auto newComponentHandle =
+                otherWorld.makeComponent(otherEntity, locateComponent(id, index));
+        }
+        if (!member->m_enabled) {
+            otherWorld.setEnabled(otherEntity, false);
+        }
     }
 
     // Remove from our world
@@ -178,115 +555,887 @@ void ecsWorld::migrateEntityTo(ecsEntity& entity, ecsWorld& otherWorld) {
 }
 
 ///////////////////////////////////////////////////////////////////////////
-/// clear
+/// evictEntities
 ///////////////////////////////////////////////////////////////////////////
 
-void ecsWorld::clear() {
-    // Remove all components
-    for (auto& m_component : m_components) {
-        const auto& [createFn, freeFn, typeSize] = ecsBaseComponent::m_componentRegistry[m_component.first];
-        const auto containerSize = m_component.second.size();
-        for (size_t i = 0; i < containerSize; i += typeSize) {
-            freeFn(reinterpret_cast<ecsBaseComponent*>(&m_component.second[i]));
+size_t ecsWorld::evictEntities(const std::vector<EntityHandle>& entityHandles, ecsColdStore& store) {
+    assertWritable();
+
+    // Encode every entity into one buffer, so the store is written once
+    ComponentDataSpace data;
+    std::vector<std::pair<EntityHandle, size_t>> records;
+    std::vector<ecsEntity*> evicted;
+    const auto write = [&data](const void* source, const size_t size) {
+        const auto* bytes = static_cast<const uint8_t*>(source);
+        data.insert(data.end(), bytes, bytes + size);
+    };
+    for (const auto& entityHandle : entityHandles) {
+        auto* entity = findEntity(entityHandle);
+        if (entity == nullptr || entity->m_parent != nullptr || !entity->m_children.empty() ||
+            std::any_of(entity->m_components.cbegin(), entity->m_components.cend(), [](const auto& component) {
+                return !std::get<3>(ecsBaseComponent::m_componentRegistry[std::get<0>(component)]);
+            })) {
+            continue;
+        }
+        if (!m_evicted.insert(entityHandle).second) {
+            continue;
+        }
+
+        // Record layout: state, tags, shared values, then component images
+        const auto recordBegin = data.size();
+        const auto enabled = static_cast<uint8_t>(entity->m_enabled);
+        write(&enabled, sizeof(enabled));
+        std::vector<ComponentID> tagIDs;
+        for (ComponentID tagID = 0; tagID < static_cast<ComponentID>(ecsBaseComponent::m_componentRegistry.size());
+             ++tagID) {
+            if (isTagID(tagID) && entity->m_signature.test(tagID)) {
+                tagIDs.emplace_back(tagID);
+            }
+        }
+        const auto tagCount = static_cast<uint32_t>(tagIDs.size());
+        write(&tagCount, sizeof(tagCount));
+        write(tagIDs.data(), tagIDs.size() * sizeof(ComponentID));
+        const auto sharedCount = static_cast<uint32_t>(entity->m_sharedComponents.size());
+        write(&sharedCount, sizeof(sharedCount));
+        for (const auto& [componentID, sharedHandle] : entity->m_sharedComponents) {
+            write(&componentID, sizeof(componentID));
+            write(sharedHandle.m_uuid, sizeof(sharedHandle.m_uuid));
         }
-        m_component.second.clear();
+        const auto componentCount = static_cast<uint32_t>(entity->m_components.size());
+        write(&componentCount, sizeof(componentCount));
+        for (const auto& [componentID, fn, componentHandle] : entity->m_components) {
+            const auto& typeSize = std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]);
+            write(&componentID, sizeof(componentID));
+            write(locateComponent(componentID, fn), typeSize);
+        }
+        records.emplace_back(entityHandle, data.size() - recordBegin);
+        evicted.emplace_back(entity);
     }
-    m_components.clear();
 
-    // Remove all entities
-    m_entities.clear();
+    // Nothing leaves the world unless the store holds it
+    if (!store.append(records, data)) {
+        for (const auto& [entityHandle, size] : records) {
+            m_evicted.erase(entityHandle);
+        }
+        return 0ULL;
+    }
+    for (auto* entity : evicted) {
+        removeEntityInternal(*entity);
+    }
+    return evicted.size();
 }
 
 ///////////////////////////////////////////////////////////////////////////
-/// generateUUID
+/// restoreEntities
 ///////////////////////////////////////////////////////////////////////////
 
-ecsHandle ecsWorld::generateUUID() {
-    constexpr auto maxRandom = 16;
-    constexpr auto minDist = 0;
-    constexpr auto maxDist = 255;
-    constexpr auto minUUIDSize = 0;
-    constexpr auto maxUUIDSize = 32;
-    std::stringstream stringStream;
+size_t ecsWorld::restoreEntities(const std::vector<EntityHandle>& entityHandles, ecsColdStore& store) {
+    assertWritable();
 
-    for (auto i = 0; i < maxRandom; i++) {
-        std::random_device random;
-        std::mt19937 generator(random());
-        std::uniform_int_distribution<int> distribution(minDist, maxDist);
-        const auto randomChar = distribution(generator);
-        std::stringstream hexstream;
-        hexstream << std::hex << randomChar;
-        const auto hex = hexstream.str();
-        stringStream << (hex.length() < 2 ? '0' + hex : hex);
-    }
-    const auto& string = stringStream.str();
-    ecsHandle handle;
-    std::copy(&string[minUUIDSize], &string[maxUUIDSize], &handle.m_uuid[minUUIDSize]);
-    return handle;
-}
+    ComponentDataSpace data;
+    ComponentDataSpace image;
+    size_t restored(0ULL);
+    for (const auto& entityHandle : entityHandles) {
+        if (m_evicted.find(entityHandle) == m_evicted.end() || !store.read(entityHandle, data)) {
+            continue;
+        }
 
-///////////////////////////////////////////////////////////////////////////
-/// isComponentIDValid
-///////////////////////////////////////////////////////////////////////////
+        // Decode the whole record first, so a truncated or stale one leaves the world untouched
+        size_t cursor(0ULL);
+        const auto read = [&data, &cursor](void* destination, const size_t size) {
+            if (size > data.size() - cursor) {
+                return false;
+            }
+            std::memcpy(destination, &data[cursor], size);
+            cursor += size;
+            return true;
+        };
+        uint8_t enabled(1U);
+        uint32_t tagCount(0U);
+        if (!read(&enabled, sizeof(enabled)) || !read(&tagCount, sizeof(tagCount))) {
+            continue;
+        }
+        bool valid(true);
+        std::vector<ComponentID> tagIDs;
+        for (uint32_t i = 0U; valid && i < tagCount; ++i) {
+            ComponentID tagID(0);
+            valid = read(&tagID, sizeof(tagID)) && isComponentIDValid(tagID) && isTagID(tagID);
+            tagIDs.emplace_back(tagID);
+        }
+        uint32_t sharedCount(0U);
+        valid = valid && read(&sharedCount, sizeof(sharedCount));
+        std::vector<std::pair<ComponentID, ComponentHandle>> sharedComponents;
+        for (uint32_t i = 0U; valid && i < sharedCount; ++i) {
+            ComponentID componentID(0);
+            ComponentHandle sharedHandle;
+            valid = read(&componentID, sizeof(componentID)) && read(sharedHandle.m_uuid, sizeof(sharedHandle.m_uuid)) &&
+                    isComponentIDValid(componentID) && !isTagID(componentID);
+            sharedComponents.emplace_back(componentID, sharedHandle);
+        }
+        uint32_t componentCount(0U);
+        valid = valid && read(&componentCount, sizeof(componentCount));
+        std::vector<std::pair<ComponentID, size_t>> images;
+        for (uint32_t i = 0U; valid && i < componentCount; ++i) {
+            ComponentID componentID(0);
+            valid = read(&componentID, sizeof(componentID)) && isComponentIDValid(componentID) &&
+                    !isTagID(componentID);
+            const auto typeSize = valid ? std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]) : 0ULL;
+            valid = valid && typeSize <= data.size() - cursor;
+            images.emplace_back(componentID, cursor);
+            cursor += valid ? typeSize : 0ULL;
+        }
+        if (!valid) {
+            continue;
+        }
 
-bool ecsWorld::isComponentIDValid(const ComponentID componentID) noexcept {
-    return static_cast<size_t>(componentID) < ecsBaseComponent::m_componentRegistry.size();
+        auto& entity = insertEntity(ecsEntity{ entityHandle, {}, {} });
+        for (const auto& tagID : tagIDs) {
+            setTagInternal(entity, tagID, true);
+        }
+
+        // Shared values may have been removed while the entity was away
+        for (const auto& [componentID, sharedHandle] : sharedComponents) {
+            if (m_sharedComponents.find(sharedHandle) != m_sharedComponents.end()) {
+                entity.m_sharedComponents.emplace_back(componentID, sharedHandle);
+            }
+        }
+
+        // Images are copied out first, as records don't keep components aligned
+        for (const auto& [componentID, offset] : images) {
+            image.resize(std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]));
+            std::memcpy(image.data(), &data[offset], image.size());
+            const auto* component = reinterpret_cast<const ecsBaseComponent*>(image.data());
+            insertComponent(entity, componentID, component->m_handle, component);
+        }
+        if (enabled == 0U) {
+            setEnabled(entity, false);
+        }
+
+        store.erase(entityHandle);
+        m_evicted.erase(entityHandle);
+        ++restored;
+    }
+    return restored;
 }
 
 ///////////////////////////////////////////////////////////////////////////
-/// makeComponentInternal
+/// setParent
 ///////////////////////////////////////////////////////////////////////////
 
-ComponentHandle ecsWorld::makeComponentInternal(
-    const EntityHandle& entityHandle, const ComponentID componentID, const ecsBaseComponent* const component) {
+bool ecsWorld::setParent(const EntityHandle& entityHandle, const EntityHandle& parentHandle) {
+    assertWritable();
+
     const auto entity = getEntity(entityHandle);
     if (entity == nullptr) {
-        return ComponentHandle();
+        return false;
     }
 
-    return makeComponentInternal(*entity, componentID, component);
-}
+    // An empty handle turns the entity into a root
+    if (!parentHandle.isValid()) {
+        if (m_recorder != nullptr) {
+            m_recorder->recordParent(entityHandle, parentHandle);
+        }
+        detachFromParent(*entity);
+        return true;
+    }
 
-///////////////////////////////////////////////////////////////////////////
+    // The new parent can't be the entity itself or one of its descendants
+    const auto parent = getEntity(parentHandle);
+    if (parent == nullptr) {
+        return false;
+    }
+    for (const auto* ancestor = parent.get(); ancestor != nullptr; ancestor = ancestor->m_parent) {
+        if (ancestor == entity.get()) {
+            return false;
+        }
+    }
 
-ComponentHandle mini::ecsWorld::makeComponentInternal(
-    ecsEntity& entity, const ComponentID componentID, const ecsBaseComponent* const component) {
-    // Check if component ID is valid
-    if (!isComponentIDValid(componentID)) {
-        return ComponentHandle();
+    if (m_recorder != nullptr) {
+        m_recorder->recordParent(entityHandle, parentHandle);
     }
 
-    // Prevent adding duplicate component types to the same entity
-    for (auto& [ID, fn, compHandle] : entity.m_components) {
-        if (ID == componentID) {
-            return compHandle;
-        }
+    // Children follow implicitly, as they only link to this entity
+    detachFromParent(*entity);
+    entity->m_parent = parent.get();
+    parent->m_children.emplace_back(entity.get());
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// getParent
+///////////////////////////////////////////////////////////////////////////
+
+EntityHandle ecsWorld::getParent(const EntityHandle& entityHandle) const {
+    const auto entity = getEntity(entityHandle);
+    if (entity == nullptr || entity->m_parent == nullptr) {
+        return EntityHandle();
     }
 
-    // Create new instance of this component
-    auto UUID = ComponentHandle(generateUUID());
-    const auto& createfn = std::get<0>(ecsBaseComponent::m_componentRegistry[componentID]);
-    entity.m_components.emplace_back(
-        componentID, createfn(m_components[componentID], UUID, entity.m_handle, component), UUID);
-    return UUID;
+    return entity->m_parent->m_handle;
 }
 
 ///////////////////////////////////////////////////////////////////////////
-/// removeComponentInternal
+/// getChildren
 ///////////////////////////////////////////////////////////////////////////
 
-bool ecsWorld::removeComponentInternal(const EntityHandle& entityHandle, const ComponentID componentID) {
+std::vector<EntityHandle> ecsWorld::getChildren(const EntityHandle& entityHandle) const {
     const auto entity = getEntity(entityHandle);
     if (entity == nullptr) {
-        return false;
+        return {};
     }
 
-    return removeComponentInternal(*entity, componentID);
+    std::vector<EntityHandle> children;
+    children.reserve(entity->m_children.size());
+    for (const auto* child : entity->m_children) {
+        children.emplace_back(child->m_handle);
+    }
+    return children;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// sortHierarchy
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsWorld::sortHierarchy(const ComponentID componentID) {
+    assertWritable();
+
+    if (!isComponentIDValid(componentID) || isTagID(componentID) || !isPooled(componentID) ||
+        findGroup(componentID) != nullptr) {
+        return false;
+    }
+    if (m_recorder != nullptr) {
+        m_recorder->recordClass(ecsTraceRecorder::Operation::SORT_HIERARCHY, componentID);
+    }
+
+    // Swap each component into the next slot, following hierarchy order
+    const auto& typeSize = std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]);
+    size_t index(0ULL);
+    for (const auto* entity : getHierarchyOrder()) {
+        // Disabled rows stay in the tail, behind every enabled row
+        if (!entity->m_enabled) {
+            continue;
+        }
+        for (const auto& [compID, fn, compHandle] : entity->m_components) {
+            if (compID == componentID) {
+                swapComponents(componentID, getByteOffset(componentID, fn), index);
+                index += typeSize;
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// getHierarchyComponents
+///////////////////////////////////////////////////////////////////////////
+
+std::vector<std::pair<ecsBaseComponent*, ecsBaseComponent*>>
+ecsWorld::getHierarchyComponents(const ComponentID componentID) {
+    if (!isComponentIDValid(componentID) || isTagID(componentID)) {
+        return {};
+    }
+
+    // Parents are linked directly, so no entity lookups are needed
+    std::vector<std::pair<ecsBaseComponent*, ecsBaseComponent*>> components;
+    auto* mem_array = isPooled(componentID) ? &m_components[componentID] : nullptr;
+    const auto findComponent = [&](const ecsEntity& entity) {
+        return mem_array == nullptr ? getComponentInternal(entity, componentID)
+                                    : getComponentInternal(entity.m_components, *mem_array, componentID);
+    };
+    for (const auto* entity : getHierarchyOrder()) {
+        if (!entity->m_enabled) {
+            continue;
+        }
+        if (auto* component = findComponent(*entity)) {
+            components.emplace_back(
+                component, entity->m_parent == nullptr ? nullptr : findComponent(*entity->m_parent));
+        }
+    }
+    return components;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// makeGroup
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsWorld::makeGroup(const std::vector<ComponentID>& componentIDs) {
+    if (componentIDs.size() < 2ULL) {
+        return false;
+    }
+
+    // Each type must be valid, unique, and not yet owned by another group
+    for (auto i = componentIDs.cbegin(); i != componentIDs.cend(); ++i) {
+        if (!isComponentIDValid(*i) || !isPooled(*i) || findGroup(*i) != nullptr ||
+            std::find(i + 1, componentIDs.cend(), *i) != componentIDs.cend()) {
+            return false;
+        }
+    }
+
+    if (m_recorder != nullptr) {
+        m_recorder->recordGroup(componentIDs);
+    }
+
+    // Pull every existing entity that qualifies into the group's range
+    auto& group = m_groups.emplace_back(ComponentGroup{ componentIDs, 0ULL });
+    for (auto& [entityHandle, entity] : m_entities) {
+        addToGroup(*entity, group);
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// addObserver
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsWorld::addObserver(const std::shared_ptr<ecsObserver>& observer) {
+    if (observer == nullptr || !observer->isValid()) {
+        return false;
+    }
+
+    ObserverState state{ observer, {}, {} };
+    for (const auto& componentID : observer->getComponentTypes()) {
+        state.m_signature.set(componentID);
+    }
+    m_observers.emplace_back(std::move(state));
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// removeObserver
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsWorld::removeObserver(const ecsObserver& observer) {
+    const auto pos = std::find_if(m_observers.begin(), m_observers.end(), [&](const auto& state) {
+        return state.m_observer.get() == &observer;
+    });
+    if (pos == m_observers.end()) {
+        return false;
+    }
+    m_observers.erase(pos);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// flushObservers
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::flushObservers() {
+    // Events are swapped out first, so observers may modify the world
+    for (size_t i = 0; i < m_observers.size(); ++i) {
+        const auto observer = m_observers[i].m_observer;
+        std::vector<std::pair<EntityHandle, bool>> events;
+        std::swap(events, m_observers[i].m_events);
+
+        // Reduce each entity's events to its first and last, so an entity
+        // added then removed within one batch is never reported
+        std::map<EntityHandle, std::pair<bool, bool>> netEvents;
+        for (const auto& [entityHandle, wasAdded] : events) {
+            netEvents.try_emplace(entityHandle, wasAdded, wasAdded).first->second.second = wasAdded;
+        }
+        std::vector<EntityHandle> added;
+        std::vector<EntityHandle> removed;
+        for (const auto& [entityHandle, firstLast] : netEvents) {
+            if (!firstLast.first) {
+                removed.emplace_back(entityHandle);
+            }
+            if (firstLast.second) {
+                added.emplace_back(entityHandle);
+            }
+        }
+
+        if (!removed.empty()) {
+            observer->onEntitiesRemoved(removed);
+        }
+        if (!added.empty()) {
+            observer->onEntitiesAdded(added);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// setDoubleBuffered
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsWorld::setDoubleBuffered(const ComponentID componentID, const bool buffered) {
+    // Snapshots copy whole pools, so only dense classes can be buffered
+    if (isTagID(componentID) || !isPooled(componentID)) {
+        return false;
+    }
+    if (m_recorder != nullptr) {
+        m_recorder->recordClass(ecsTraceRecorder::Operation::SET_DOUBLE_BUFFERED, componentID, buffered);
+    }
+    if (buffered) {
+        m_bufferedTypes.set(componentID);
+    } else {
+        m_bufferedTypes.reset(componentID);
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// flipBuffers
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::flipBuffers() {
+    assertWritable();
+
+    if (m_recorder != nullptr) {
+        m_recorder->recordOperation(ecsTraceRecorder::Operation::FLIP_BUFFERS);
+    }
+
+    // Snapshots share their pools' offsets, so buffered pools shed their tombstones first
+    for (auto tombstones = m_tombstones.begin(); tombstones != m_tombstones.end();) {
+        const auto componentID = (tombstones++)->first;
+        if (m_bufferedTypes.test(componentID)) {
+            compactPool(componentID);
+        }
+    }
+
+    // The back snapshot keeps its capacity, so steady-state flips don't allocate
+    auto& snapshot = m_snapshots[1ULL - m_frontSnapshot];
+    snapshot.clear();
+
+    // Copy each buffered pool's enabled rows in order, so component offsets are unchanged
+    for (const auto& [componentID, mem_array] : m_components) {
+        if (!m_bufferedTypes.test(componentID)) {
+            continue;
+        }
+        const auto& [createFn, freeFn, typeSize, trivialCopy, storage] =
+            ecsBaseComponent::m_componentRegistry[componentID];
+        const auto activeEnd = countActiveRows(componentID) * typeSize;
+        auto& copy = snapshot.m_components[componentID];
+        if (trivialCopy) {
+            copy.assign(mem_array.cbegin(), std::next(mem_array.cbegin(), static_cast<std::ptrdiff_t>(activeEnd)));
+            continue;
+        }
+        copy.reserve(activeEnd);
+        for (size_t i = 0; i < activeEnd; i += typeSize) {
+            const auto* component = reinterpret_cast<const ecsBaseComponent*>(&mem_array[i]);
+            createFn(copy, component->m_handle, component->m_entityHandle, component);
+        }
+    }
+
+    // Rows name their owners, so records come from the buffered pools alone, skipping the disabled tails
+    auto& rows = snapshot.m_rows;
+    rows.clear();
+    for (const auto& [componentID, mem_array] : m_components) {
+        if (!m_bufferedTypes.test(componentID)) {
+            continue;
+        }
+        const auto& typeSize = std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]);
+        const auto activeEnd = countActiveRows(componentID) * typeSize;
+        for (size_t i = 0; i < activeEnd; i += typeSize) {
+            const auto* component = reinterpret_cast<const ecsBaseComponent*>(&mem_array[i]);
+            rows.emplace_back(component->m_entityHandle, componentID, i);
+        }
+    }
+
+    // Sorting by owner keeps the records sorted by handle, each owning a run of slots.
+    // Handles convert to bool, so tuples must not compare them on their own.
+    std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) { return std::get<0>(a) < std::get<0>(b); });
+    snapshot.m_slots.reserve(rows.size());
+    for (const auto& [entityHandle, componentID, offset] : rows) {
+        if (snapshot.m_entities.empty() || !(snapshot.m_entities.back().m_handle == entityHandle)) {
+            snapshot.m_entities.push_back({ entityHandle, snapshot.m_slots.size(), 0ULL });
+        }
+        snapshot.m_slots.emplace_back(componentID, offset);
+        ++snapshot.m_entities.back().m_slotCount;
+    }
+
+    snapshot.m_frame = ++m_flipCount;
+    m_frontSnapshot = 1ULL - m_frontSnapshot;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// flipEvents
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::flipEvents() {
+    assertWritable();
+
+    if (m_recorder != nullptr) {
+        m_recorder->recordOperation(ecsTraceRecorder::Operation::FLIP_EVENTS);
+    }
+
+    for (auto& [eventType, channel] : m_eventChannels) {
+        channel->flip();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// spliceSpawnBuffer
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::spliceSpawnBuffer(ecsSpawnBuffer& buffer) {
+    assertWritable();
+
+    // Append each staged pool in order, remembering where it begins
+    std::map<ComponentID, ComponentIndex> baseRows;
+    for (const auto& [componentID, staged] : buffer.m_components) {
+        const auto& [createFn, freeFn, typeSize, trivialCopy, storage] =
+            ecsBaseComponent::m_componentRegistry[componentID];
+        if (storage != ecsStoragePolicy::DENSE) {
+            continue;
+        }
+        auto& mem_array = m_components[componentID];
+        baseRows[componentID] = toComponentIndex(mem_array.size() / typeSize);
+        m_disabledCounts[componentID] += staged.size() / typeSize;
+        bumpStructuralVersion(componentID);
+        if (trivialCopy) {
+            if (!staged.empty()) {
+                toComponentIndex((mem_array.size() + staged.size()) / typeSize - 1ULL);
+            }
+            mem_array.insert(mem_array.end(), staged.cbegin(), staged.cend());
+            continue;
+        }
+        mem_array.reserve(mem_array.size() + staged.size());
+        for (size_t i = 0; i < staged.size(); i += typeSize) {
+            const auto* component = reinterpret_cast<const ecsBaseComponent*>(&staged[i]);
+            createFn(mem_array, component->m_handle, component->m_entityHandle, component);
+        }
+    }
+
+    // Adopt each staged entity, rebasing its rows onto this world's pools and stores
+    std::vector<ecsEntity*> adopted;
+    adopted.reserve(buffer.m_entities.size());
+    for (auto& staged : buffer.m_entities) {
+        auto& entity = insertEntity(std::move(staged));
+        for (auto& [componentID, index, componentHandle] : entity.m_components) {
+            if (isPooled(componentID)) {
+                index += baseRows[componentID];
+                continue;
+            }
+            const auto& stagedPool = buffer.m_components[componentID];
+            index = storeComponent(
+                componentID, componentHandle, entity.m_handle,
+                reinterpret_cast<const ecsBaseComponent*>(&stagedPool[getByteOffset(componentID, index)]));
+        }
+        adopted.emplace_back(&entity);
+    }
+
+    // Appended rows joined the disabled tail, every owner is known before they leave it
+    for (auto* adoptee : adopted) {
+        auto& entity = *adoptee;
+        for (const auto& [componentID, index, componentHandle] : entity.m_components) {
+            stampAdded(componentID, index);
+        }
+        for (const auto& [componentID, index, componentHandle] : entity.m_components) {
+            activateRow(componentID, getByteOffset(componentID, index));
+        }
+        for (const auto& [componentID, index, componentHandle] : entity.m_components) {
+            if (auto* group = findGroup(componentID)) {
+                addToGroup(entity, *group);
+            }
+        }
+        for (auto& state : m_observers) {
+            if (entity.m_signature.containsAll(state.m_signature)) {
+                state.m_events.emplace_back(entity.m_handle, true);
+            }
+        }
+    }
+    for (const auto& [componentID, baseRow] : baseRows) {
+        refreshPlans(componentID);
+    }
+    buffer.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// clear
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::clear() {
+    assertWritable();
+
+    if (m_recorder != nullptr) {
+        m_recorder->recordOperation(ecsTraceRecorder::Operation::CLEAR);
+    }
+
+    // Observers still hear about every entity leaving
+    if (!m_observers.empty()) {
+        for (const auto& [entityHandle, entity] : m_entities) {
+            recordRemoved(*entity);
+        }
+    }
+
+    // Remove all components, stored ones are only known through their entities
+    for (auto& [componentID, mem_array] : m_components) {
+        freeComponents(componentID, mem_array, findTombstones(componentID));
+    }
+    m_components.clear();
+    m_tombstones.clear();
+    m_chunkTicks.clear();
+    bumpStructuralVersions();
+    for (const auto& [entityHandle, entity] : m_entities) {
+        for (const auto& [componentID, fn, componentHandle] : entity->m_components) {
+            const auto& freeFn = std::get<1>(ecsBaseComponent::m_componentRegistry[componentID]);
+            if (!isPooled(componentID) && freeFn != nullptr) {
+                freeFn(locateComponent(componentID, fn));
+            }
+        }
+    }
+    m_stores.clear();
+    m_disabledCounts.clear();
+    m_evicted.clear();
+    m_census.clear();
+    m_plans.clear();
+    m_plannedRows.clear();
+
+    // Channels stay valid but lose their events
+    for (auto& [eventType, channel] : m_eventChannels) {
+        channel->discard();
+    }
+
+    // Remove all singletons and shared values
+    for (auto& [componentID, mem_array] : m_singletons) {
+        freeComponents(componentID, mem_array);
+    }
+    m_singletons.clear();
+    for (auto& [sharedHandle, mem_array] : m_sharedComponents) {
+        freeComponents(reinterpret_cast<ecsBaseComponent*>(mem_array.data())->m_runtimeID, mem_array);
+    }
+    m_sharedComponents.clear();
+
+    // Remove all entities
+    m_entities.clear();
+
+    // Groups remain declared but are now empty
+    for (auto& group : m_groups) {
+        group.m_size = 0ULL;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// generateUUID
+///////////////////////////////////////////////////////////////////////////
+
+ecsHandle ecsWorld::generateUUID() { return makeUUID(reserveUUIDs(1ULL)); }
+
+///////////////////////////////////////////////////////////////////////////
+/// reserveUUIDs
+///////////////////////////////////////////////////////////////////////////
+
+uint64_t ecsWorld::reserveUUIDs(const size_t count) noexcept {
+    static std::atomic<uint64_t> sequence(1ULL);
+    return sequence.fetch_add(count, std::memory_order_relaxed);
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// makeUUID
+///////////////////////////////////////////////////////////////////////////
+
+ecsHandle ecsWorld::makeUUID(const uint64_t sequence) noexcept {
+    // A random per-process prefix keeps handles unique across processes
+    static const uint64_t prefix = [] {
+        std::random_device random;
+        return (static_cast<uint64_t>(random()) << 32U) ^ static_cast<uint64_t>(random());
+    }();
+    constexpr auto digits = "0123456789abcdef";
+    constexpr auto halfUUIDSize = 16U;
+    ecsHandle handle;
+    for (auto i = 0U; i < halfUUIDSize; ++i) {
+        const auto shift = (halfUUIDSize - 1U - i) * 4U;
+        handle.m_uuid[i] = digits[(prefix >> shift) & 0xFU];
+        handle.m_uuid[halfUUIDSize + i] = digits[(sequence >> shift) & 0xFU];
+    }
+    return handle;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// detachFromParent
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::detachFromParent(ecsEntity& entity) {
+    if (entity.m_parent == nullptr) {
+        return;
+    }
+
+    auto& siblings = entity.m_parent->m_children;
+    siblings.erase(std::remove(siblings.begin(), siblings.end(), &entity), siblings.end());
+    entity.m_parent = nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// getSubtree
+///////////////////////////////////////////////////////////////////////////
+
+std::vector<ecsEntity*> ecsWorld::getSubtree(ecsEntity& entity) {
+    std::vector<ecsEntity*> subtree{ &entity };
+    for (size_t i = 0; i < subtree.size(); ++i) {
+        const auto& children = subtree[i]->m_children;
+        subtree.insert(subtree.end(), children.cbegin(), children.cend());
+    }
+    return subtree;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// getHierarchyOrder
+///////////////////////////////////////////////////////////////////////////
+
+std::vector<ecsEntity*> ecsWorld::getHierarchyOrder() const {
+    std::vector<ecsEntity*> order;
+    order.reserve(m_entities.size());
+    for (const auto& [entityHandle, entity] : m_entities) {
+        if (entity->m_parent == nullptr) {
+            order.emplace_back(entity.get());
+        }
+    }
+    for (size_t i = 0; i < order.size(); ++i) {
+        const auto& children = order[i]->m_children;
+        order.insert(order.end(), children.cbegin(), children.cend());
+    }
+    return order;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// isComponentIDValid
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsWorld::isComponentIDValid(const ComponentID componentID) noexcept {
+    return static_cast<size_t>(componentID) < ecsBaseComponent::m_componentRegistry.size();
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// isTagID
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsWorld::isTagID(const ComponentID componentID) noexcept {
+    return isComponentIDValid(componentID) && std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]) == 0ULL;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// setTagInternal
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsWorld::setTagInternal(const EntityHandle& entityHandle, const ComponentID tagID, const bool value) {
+    const auto entity = getEntity(entityHandle);
+    if (entity == nullptr) {
+        return false;
+    }
+
+    return setTagInternal(*entity, tagID, value);
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsWorld::setTagInternal(ecsEntity& entity, const ComponentID tagID, const bool value) {
+    assertWritable();
+
+    if (!isTagID(tagID)) {
+        return false;
+    }
+
+    if (m_recorder != nullptr && entity.m_signature.test(tagID) != value) {
+        m_recorder->recordType(ecsTraceRecorder::Operation::SET_TAG, entity.m_handle, tagID, value);
+    }
+    if (value && !entity.m_signature.test(tagID)) {
+        setSignatureBit(entity, tagID, true);
+        recordAdded(entity, tagID);
+    } else if (!value && entity.m_signature.test(tagID)) {
+        recordRemoved(entity, tagID);
+        setSignatureBit(entity, tagID, false);
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// makeComponentInternal
+///////////////////////////////////////////////////////////////////////////
+
+ComponentHandle ecsWorld::makeComponentInternal(
+    const EntityHandle& entityHandle, const ComponentID componentID, const ecsBaseComponent* const component) {
+    const auto entity = getEntity(entityHandle);
+    if (entity == nullptr) {
+        return ComponentHandle();
+    }
+
+    return makeComponentInternal(*entity, componentID, component);
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+ComponentHandle mini::ecsWorld::makeComponentInternal(
+    ecsEntity& entity, const ComponentID componentID, const ecsBaseComponent* const component) {
+    assertWritable();
+
+    // Check if component ID is valid, tags are set with addTag instead
+    if (!isComponentIDValid(componentID) || isTagID(componentID)) {
+        return ComponentHandle();
+    }
+
+    // Prevent adding duplicate component types to the same entity
+    for (auto& [ID, fn, compHandle] : entity.m_components) {
+        if (ID == componentID) {
+            return compHandle;
+        }
+    }
+
+    // Create new instance of this component
+    auto UUID = ComponentHandle(generateUUID());
+    insertComponent(entity, componentID, UUID, component);
+    return UUID;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// insertComponent
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::insertComponent(
+    ecsEntity& entity, const ComponentID componentID, const ComponentHandle& componentHandle,
+    const ecsBaseComponent* const component) {
+    const auto& createfn = std::get<0>(ecsBaseComponent::m_componentRegistry[componentID]);
+    const auto pooled = isPooled(componentID);
+    const auto* poolData = pooled ? m_components[componentID].data() : nullptr;
+    const auto index = pooled ? createfn(m_components[componentID], componentHandle, entity.m_handle, component)
+                              : storeComponent(componentID, componentHandle, entity.m_handle, component);
+    entity.m_components.emplace_back(componentID, index, componentHandle);
+
+    // Only a reallocated pool moves existing components
+    if ((pooled && poolData != m_components[componentID].data()) || getStructuralVersion(componentID) == 0ULL) {
+        bumpStructuralVersion(componentID);
+    }
+    setSignatureBit(entity, componentID, true);
+    stampAdded(componentID, index);
+    if (m_recorder != nullptr) {
+        m_recorder->recordType(ecsTraceRecorder::Operation::MAKE_COMPONENT, entity.m_handle, componentID);
+    }
+
+    // New rows join the disabled tail, enabled entities then leave it
+    if (pooled) {
+        ++m_disabledCounts[componentID];
+        if (entity.m_enabled) {
+            activateRow(componentID, getByteOffset(componentID, index));
+        }
+    }
+    recordAdded(entity, componentID);
+
+    // Completing a group's type set moves the entity into the group's range
+    if (auto* group = findGroup(componentID)) {
+        addToGroup(entity, *group);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// removeComponentInternal
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsWorld::removeComponentInternal(const EntityHandle& entityHandle, const ComponentID componentID) {
+    const auto entity = getEntity(entityHandle);
+    if (entity == nullptr) {
+        return false;
+    }
+
+    return removeComponentInternal(*entity, componentID);
 }
 
 ///////////////////////////////////////////////////////////////////////////
 
 bool mini::ecsWorld::removeComponentInternal(ecsEntity& entity, const ComponentID componentID) {
+    // Losing a grouped type moves the entity out of the group's range
+    if (auto* group = findGroup(componentID)) {
+        removeFromGroup(entity, *group);
+    }
+
     auto& entityComponents = entity.m_components;
     const auto entityComponentCount = entityComponents.size();
     for (auto i = 0ULL; i < entityComponentCount; ++i) {
@@ -297,199 +1446,1516 @@ bool mini::ecsWorld::removeComponentInternal(ecsEntity& entity, const ComponentI
             const auto destIndex = i;
             entityComponents[destIndex] = entityComponents[srcIndex];
             entityComponents.pop_back();
+            recordRemoved(entity, componentID);
+            setSignatureBit(entity, componentID, false);
+            if (m_recorder != nullptr) {
+                m_recorder->recordType(ecsTraceRecorder::Operation::REMOVE_COMPONENT, entity.m_handle, componentID);
+            }
             return true;
         }
     }
 
-    return false;
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::removeComponentInternal(const ComponentID componentID, const ComponentIndex index) {
+    assertWritable();
+
+    // Stored components never move, so nothing else needs patching
+    if (isComponentIDValid(componentID) && !isPooled(componentID)) {
+        bumpStructuralVersion(componentID);
+        releaseComponent(componentID, index);
+        return;
+    }
+
+    if (isComponentIDValid(componentID)) {
+        bumpStructuralVersion(componentID);
+        auto& mem_array = m_components[componentID];
+        const auto& [createFn, freeFn, typeSize, trivialCopy, storage] =
+            ecsBaseComponent::m_componentRegistry[componentID];
+
+        // Tombstoned rows keep their place, so nothing moves until compaction
+        if (m_tombstoneMode) {
+            if (freeFn != nullptr) {
+                freeFn(reinterpret_cast<ecsBaseComponent*>(&mem_array[getByteOffset(componentID, index)]));
+            }
+            auto& tombstones = m_tombstones[componentID];
+            const auto row = static_cast<size_t>(index);
+            if (tombstones.m_dead.size() <= row) {
+                tombstones.m_dead.resize(mem_array.size() / typeSize);
+            }
+            tombstones.m_dead[row] = true;
+            ++tombstones.m_count;
+            return;
+        }
+
+        const auto srcIndex = mem_array.size() - typeSize;
+
+        // Keep the disabled tail intact, an active row first swaps to its edge
+        auto destIndex = getByteOffset(componentID, index);
+        if (const auto disabled = m_disabledCounts.find(componentID);
+            disabled != m_disabledCounts.end() && disabled->second != 0ULL) {
+            const auto activeEnd = mem_array.size() - disabled->second * typeSize;
+            if (destIndex < activeEnd) {
+                swapComponents(componentID, destIndex, activeEnd - typeSize);
+                destIndex = activeEnd - typeSize;
+            } else {
+                --disabled->second;
+            }
+        }
+
+        const auto* srcComponent = reinterpret_cast<ecsBaseComponent*>(&mem_array[srcIndex]);
+        auto* destComponent = reinterpret_cast<ecsBaseComponent*>(&mem_array[destIndex]);
+        if (freeFn != nullptr) {
+            freeFn(destComponent);
+        }
+
+        if (destIndex == srcIndex) {
+            mem_array.resize(srcIndex);
+            return;
+        }
+        std::memcpy(static_cast<void*>(destComponent), static_cast<const void*>(srcComponent), typeSize);
+        raiseChunkTick(componentID, destIndex, destComponent->m_changedTick);
+
+        // Update references
+        for (auto& component : findEntity(srcComponent->m_entityHandle)->m_components) {
+            auto& [compID, fn, compHandle] = component;
+            if (componentID == compID && static_cast<size_t>(fn) == srcIndex / typeSize) {
+                fn = toComponentIndex(destIndex / typeSize);
+                break;
+            }
+        }
+        mem_array.resize(srcIndex);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// locateComponent
+///////////////////////////////////////////////////////////////////////////
+
+ecsBaseComponent* ecsWorld::locateComponent(const ComponentID componentID, const ComponentIndex index) const noexcept {
+    if (isPooled(componentID)) {
+        return reinterpret_cast<ecsBaseComponent*>(&(*findPool(componentID))[getByteOffset(componentID, index)]);
+    }
+
+    const auto& store = m_stores.find(componentID)->second;
+    const auto& typeSize = std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]);
+    const auto slot = static_cast<size_t>(index);
+    return reinterpret_cast<ecsBaseComponent*>(
+        store.m_pages[slot / store.m_pageSlots].get() + (slot % store.m_pageSlots) * typeSize);
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// storeComponent
+///////////////////////////////////////////////////////////////////////////
+
+ComponentIndex ecsWorld::storeComponent(
+    const ComponentID componentID, const ComponentHandle& componentHandle, const EntityHandle& entityHandle,
+    const ecsBaseComponent* const component) {
+    const auto& [createFn, freeFn, typeSize, trivialCopy, storage] = ecsBaseComponent::m_componentRegistry[componentID];
+    const auto [position, inserted] = m_stores.try_emplace(componentID);
+    auto& store = position->second;
+    if (inserted && storage == ecsStoragePolicy::PAGED) {
+        store.m_pageSlots = std::max<size_t>(STORE_PAGE_BYTES / typeSize, 1ULL);
+    }
+
+    // Released slots are reused before any new slot is handed out
+    ComponentIndex slot(0);
+    if (!store.m_freeSlots.empty()) {
+        slot = store.m_freeSlots.back();
+        store.m_freeSlots.pop_back();
+    } else {
+        slot = toComponentIndex(store.m_slotCount);
+        ++store.m_slotCount;
+    }
+    const auto page = static_cast<size_t>(slot) / store.m_pageSlots;
+    if (page >= store.m_pages.size()) {
+        store.m_pages.resize(page + 1ULL);
+    }
+    if (store.m_pages[page] == nullptr) {
+        store.m_pages[page] = std::make_unique<uint8_t[]>(store.m_pageSlots * typeSize);
+    }
+
+    // Components are built aside, then moved bytewise into their slot as pools move them
+    store.m_scratch.clear();
+    createFn(store.m_scratch, componentHandle, entityHandle, component);
+    std::memcpy(static_cast<void*>(locateComponent(componentID, slot)), store.m_scratch.data(), typeSize);
+    return slot;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// releaseComponent
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::releaseComponent(const ComponentID componentID, const ComponentIndex slot) {
+    if (const auto& freeFn = std::get<1>(ecsBaseComponent::m_componentRegistry[componentID]); freeFn != nullptr) {
+        freeFn(locateComponent(componentID, slot));
+    }
+
+    // Sparse classes are rare and large, so their memory is returned right away
+    auto& store = m_stores[componentID];
+    store.m_freeSlots.emplace_back(slot);
+    if (store.m_pageSlots == 1ULL) {
+        store.m_pages[static_cast<size_t>(slot)].reset();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// makeSingletonInternal
+///////////////////////////////////////////////////////////////////////////
+
+ecsBaseComponent*
+ecsWorld::makeSingletonInternal(const ComponentID componentID, const ecsBaseComponent* const component) {
+    assertWritable();
+
+    if (!isComponentIDValid(componentID) || isTagID(componentID)) {
+        return nullptr;
+    }
+
+    // Only one instance of each class may exist
+    if (auto* singleton = getSingletonInternal(componentID)) {
+        return singleton;
+    }
+    if (m_recorder != nullptr) {
+        m_recorder->recordClass(ecsTraceRecorder::Operation::MAKE_SINGLETON, componentID);
+    }
+
+    auto& mem_array = m_singletons[componentID];
+    const auto& createfn = std::get<0>(ecsBaseComponent::m_componentRegistry[componentID]);
+    return reinterpret_cast<ecsBaseComponent*>(
+        &mem_array[createfn(mem_array, ComponentHandle(generateUUID()), EntityHandle(), component)]);
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// getSingletonInternal
+///////////////////////////////////////////////////////////////////////////
+
+ecsBaseComponent* ecsWorld::getSingletonInternal(const ComponentID componentID) noexcept {
+    const auto pos = m_singletons.find(componentID);
+    if (pos == m_singletons.end() || pos->second.empty()) {
+        return nullptr;
+    }
+
+    return reinterpret_cast<ecsBaseComponent*>(pos->second.data());
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// removeSingletonInternal
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsWorld::removeSingletonInternal(const ComponentID componentID) {
+    assertWritable();
+
+    const auto pos = m_singletons.find(componentID);
+    if (pos == m_singletons.end()) {
+        return false;
+    }
+    if (m_recorder != nullptr) {
+        m_recorder->recordClass(ecsTraceRecorder::Operation::REMOVE_SINGLETON, componentID);
+    }
+
+    freeComponents(componentID, pos->second);
+    m_singletons.erase(pos);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// resolveSingletons
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsWorld::resolveSingletons(ecsSystem& system) {
+    system.m_singletons.clear();
+    for (const auto& componentID : system.getSingletonTypes()) {
+        auto* singleton = getSingletonInternal(componentID);
+        if (singleton == nullptr) {
+            return false;
+        }
+        system.m_singletons.emplace_back(singleton);
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// makeSharedComponentInternal
+///////////////////////////////////////////////////////////////////////////
+
+ComponentHandle
+ecsWorld::makeSharedComponentInternal(const ComponentID componentID, const ecsBaseComponent* const component) {
+    assertWritable();
+
+    if (!isComponentIDValid(componentID) || isTagID(componentID)) {
+        return ComponentHandle();
+    }
+
+    // Each shared value owns its own memory, so its address never changes
+    auto UUID = ComponentHandle(generateUUID());
+    const auto& createfn = std::get<0>(ecsBaseComponent::m_componentRegistry[componentID]);
+    createfn(m_sharedComponents[UUID], UUID, EntityHandle(), component);
+    if (m_recorder != nullptr) {
+        m_recorder->recordShared(ecsTraceRecorder::Operation::MAKE_SHARED, EntityHandle(), UUID, componentID);
+    }
+    return UUID;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// getSharedComponentInternal
+///////////////////////////////////////////////////////////////////////////
+
+ecsBaseComponent* ecsWorld::getSharedComponentInternal(const ComponentHandle& sharedHandle) noexcept {
+    const auto pos = m_sharedComponents.find(sharedHandle);
+    if (pos == m_sharedComponents.end()) {
+        return nullptr;
+    }
+
+    return reinterpret_cast<ecsBaseComponent*>(pos->second.data());
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+ecsBaseComponent*
+ecsWorld::getSharedComponentInternal(const ecsEntity& entity, const ComponentID componentID) noexcept {
+    for (const auto& [sharedID, sharedHandle] : entity.m_sharedComponents) {
+        if (sharedID == componentID) {
+            return getSharedComponentInternal(sharedHandle);
+        }
+    }
+    return nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// unsetSharedComponentInternal
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsWorld::unsetSharedComponentInternal(const EntityHandle& entityHandle, const ComponentID componentID) {
+    assertWritable();
+
+    const auto entity = getEntity(entityHandle);
+    if (entity == nullptr) {
+        return false;
+    }
+
+    auto& sharedComponents = entity->m_sharedComponents;
+    const auto pos = std::find_if(sharedComponents.begin(), sharedComponents.end(), [&](const auto& shared) {
+        return shared.first == componentID;
+    });
+    if (pos == sharedComponents.end()) {
+        return false;
+    }
+    if (m_recorder != nullptr) {
+        m_recorder->recordType(ecsTraceRecorder::Operation::UNSET_SHARED, entityHandle, componentID);
+    }
+    sharedComponents.erase(pos);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// freeComponents
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::freeComponents(
+    const ComponentID componentID, ComponentDataSpace& mem_array, const Tombstones* const tombstones) {
+    // Trivially destructible components need no per-component work, tombstoned ones were already freed
+    const auto& [createFn, freeFn, typeSize, trivialCopy, storage] = ecsBaseComponent::m_componentRegistry[componentID];
+    if (freeFn != nullptr) {
+        const auto containerSize = mem_array.size();
+        for (size_t i = 0; i < containerSize; i += typeSize) {
+            if (tombstones == nullptr || !tombstones->isDead(i / typeSize)) {
+                freeFn(reinterpret_cast<ecsBaseComponent*>(&mem_array[i]));
+            }
+        }
+    }
+    mem_array.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// bumpStructuralVersion
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::bumpStructuralVersion(const ComponentID componentID) {
+    const auto index = static_cast<size_t>(componentID);
+    if (m_structuralVersions.size() <= index) {
+        m_structuralVersions.resize(index + 1ULL, 0ULL);
+    }
+    m_structuralVersions[index] = nextStructuralVersion();
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// bumpStructuralVersions
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::bumpStructuralVersions() {
+    m_structuralVersions.resize(ecsBaseComponent::m_componentRegistry.size(), 0ULL);
+    for (auto& version : m_structuralVersions) {
+        version = nextStructuralVersion();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// nextStructuralVersion
+///////////////////////////////////////////////////////////////////////////
+
+uint64_t ecsWorld::nextStructuralVersion() noexcept {
+    static std::atomic<uint64_t> version(0ULL);
+    return version.fetch_add(1ULL, std::memory_order_relaxed) + 1ULL;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// stampAdded
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::stampAdded(const ComponentID componentID, const ComponentIndex index) {
+    auto* component = locateComponent(componentID, index);
+    component->m_addedTick = m_changeTick;
+    component->m_changedTick = m_changeTick;
+    if (isPooled(componentID)) {
+        raiseChunkTick(componentID, getByteOffset(componentID, index), m_changeTick);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// raiseChunkTick
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::raiseChunkTick(const ComponentID componentID, const size_t index, const uint64_t tick) {
+    // Summaries only grow, so a chunk is skipped only if none of its rows could be newer
+    auto& chunkTicks = m_chunkTicks[componentID];
+    const auto chunk = index / std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]) / CHANGE_CHUNK_ROWS;
+    if (chunkTicks.size() <= chunk) {
+        chunkTicks.resize(chunk + 1ULL, 0ULL);
+    }
+    chunkTicks[chunk] = std::max(chunkTicks[chunk], tick);
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// findTombstones
+///////////////////////////////////////////////////////////////////////////
+
+const ecsWorld::Tombstones* ecsWorld::findTombstones(const ComponentID componentID) const noexcept {
+    const auto tombstones = m_tombstones.find(componentID);
+    return tombstones == m_tombstones.cend() ? nullptr : &tombstones->second;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// compactPool
+///////////////////////////////////////////////////////////////////////////
+
+size_t ecsWorld::compactPool(const ComponentID componentID) {
+    const auto tombstones = m_tombstones.find(componentID);
+    if (tombstones == m_tombstones.end()) {
+        return 0ULL;
+    }
+
+    // Live rows slide down in order, so groups and the disabled tail keep their shape
+    auto& mem_array = m_components[componentID];
+    const auto& typeSize = std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]);
+    const auto& dead = tombstones->second;
+    const auto rowCount = mem_array.size() / typeSize;
+    const auto activeRows = countActiveRows(componentID);
+    size_t deadDisabled(0ULL);
+    size_t writeRow(0ULL);
+    for (size_t readRow = 0; readRow < rowCount; ++readRow) {
+        if (dead.isDead(readRow)) {
+            deadDisabled += readRow >= activeRows ? 1ULL : 0ULL;
+            continue;
+        }
+        if (writeRow != readRow) {
+            auto* destComponent = &mem_array[writeRow * typeSize];
+            std::memcpy(destComponent, &mem_array[readRow * typeSize], typeSize);
+            const auto* component = reinterpret_cast<ecsBaseComponent*>(destComponent);
+            raiseChunkTick(componentID, writeRow * typeSize, component->m_changedTick);
+            for (auto& [compID, fn, compHandle] : findEntity(component->m_entityHandle)->m_components) {
+                if (compID == componentID) {
+                    fn = toComponentIndex(writeRow);
+                    break;
+                }
+            }
+        }
+        ++writeRow;
+    }
+    mem_array.resize(writeRow * typeSize);
+    if (deadDisabled != 0ULL) {
+        m_disabledCounts[componentID] -= deadDisabled;
+    }
+
+    const auto reclaimed = dead.m_count;
+    m_tombstones.erase(tombstones);
+    bumpStructuralVersion(componentID);
+    refreshPlans(componentID);
+    return reclaimed;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// swapComponents
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::swapComponents(const ComponentID componentID, const size_t indexA, const size_t indexB) {
+    assertWritable();
+
+    if (indexA == indexB) {
+        return;
+    }
+    bumpStructuralVersion(componentID);
+
+    auto& mem_array = m_components[componentID];
+    const auto& typeSize = std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]);
+    std::swap_ranges(
+        mem_array.begin() + static_cast<std::ptrdiff_t>(indexA),
+        mem_array.begin() + static_cast<std::ptrdiff_t>(indexA + typeSize),
+        mem_array.begin() + static_cast<std::ptrdiff_t>(indexB));
+
+    // Tombstones travel with their rows
+    auto tombstones = m_tombstones.find(componentID);
+    if (tombstones != m_tombstones.end()) {
+        auto& dead = tombstones->second.m_dead;
+        dead.resize(std::max<size_t>(dead.size(), std::max(indexA, indexB) / typeSize + 1ULL));
+        const bool deadA = dead[indexA / typeSize];
+        dead[indexA / typeSize] = dead[indexB / typeSize];
+        dead[indexB / typeSize] = deadA;
+    }
+
+    // Update references and change summaries, dead rows have no owner
+    for (const auto index : { indexA, indexB }) {
+        if (tombstones != m_tombstones.end() && tombstones->second.isDead(index / typeSize)) {
+            continue;
+        }
+        const auto* component = reinterpret_cast<ecsBaseComponent*>(&mem_array[index]);
+        raiseChunkTick(componentID, index, component->m_changedTick);
+        for (auto& [compID, fn, compHandle] : getEntity(component->m_entityHandle)->m_components) {
+            if (compID == componentID) {
+                fn = toComponentIndex(index / typeSize);
+                break;
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// findGroup
+///////////////////////////////////////////////////////////////////////////
+
+ecsWorld::ComponentGroup* ecsWorld::findGroup(const ComponentID componentID) noexcept {
+    return const_cast<ComponentGroup*>(std::as_const(*this).findGroup(componentID));
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+const ecsWorld::ComponentGroup* ecsWorld::findGroup(const ComponentID componentID) const noexcept {
+    for (const auto& group : m_groups) {
+        if (std::find(group.m_componentIDs.cbegin(), group.m_componentIDs.cend(), componentID) !=
+            group.m_componentIDs.cend()) {
+            return &group;
+        }
+    }
+    return nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+const ecsWorld::ComponentGroup* ecsWorld::findGroupFor(
+    const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes) const noexcept {
+    // The required types must match a group's types exactly
+    const ComponentGroup* group = nullptr;
+    size_t requiredCount(0ULL);
+    for (const auto& [componentID, componentFlag] : componentTypes) {
+        if (componentFlag != ecsSystem::RequirementsFlag::REQUIRED) {
+            continue;
+        }
+
+        const auto* owner = findGroup(componentID);
+        if (owner == nullptr || (group != nullptr && owner != group)) {
+            return nullptr;
+        }
+        group = owner;
+        ++requiredCount;
+    }
+
+    if (group == nullptr || requiredCount != group->m_componentIDs.size()) {
+        return nullptr;
+    }
+    return group;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// addToGroup
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::addToGroup(ecsEntity& entity, ComponentGroup& group) {
+    if (!entity.m_enabled || isInGroup(entity, group)) {
+        return;
+    }
+
+    // The entity must own every type in the group
+    for (const auto& componentID : group.m_componentIDs) {
+        if (std::none_of(entity.m_components.cbegin(), entity.m_components.cend(), [&](const auto& component) {
+                return std::get<0>(component) == componentID;
+            })) {
+            return;
+        }
+    }
+
+    // Swap each of its components into the first slot past the group's range
+    for (const auto& componentID : group.m_componentIDs) {
+        const auto& typeSize = std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]);
+        for (const auto& [compID, fn, compHandle] : entity.m_components) {
+            if (compID == componentID) {
+                swapComponents(componentID, getByteOffset(componentID, fn), group.m_size * typeSize);
+                break;
+            }
+        }
+    }
+    ++group.m_size;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// removeFromGroup
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::removeFromGroup(ecsEntity& entity, ComponentGroup& group) {
+    if (!isInGroup(entity, group)) {
+        return;
+    }
+
+    // Swap each of its components into the last slot of the group's range
+    --group.m_size;
+    for (const auto& componentID : group.m_componentIDs) {
+        const auto& typeSize = std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]);
+        for (const auto& [compID, fn, compHandle] : entity.m_components) {
+            if (compID == componentID) {
+                swapComponents(componentID, getByteOffset(componentID, fn), group.m_size * typeSize);
+                break;
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// isInGroup
+///////////////////////////////////////////////////////////////////////////
+
+bool ecsWorld::isInGroup(const ecsEntity& entity, const ComponentGroup& group) noexcept {
+    // Group members fill the leading range of every pool, so one type suffices
+    const auto& componentID = group.m_componentIDs.front();
+    for (const auto& [compID, fn, compHandle] : entity.m_components) {
+        if (compID == componentID) {
+            return static_cast<size_t>(fn) < group.m_size;
+        }
+    }
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// getComponentInternal
+///////////////////////////////////////////////////////////////////////////
+
+ecsBaseComponent*
+ecsWorld::getComponentInternal(const EntityHandle& entityHandle, const ComponentID componentID) const {
+    const auto* entity = findEntity(entityHandle);
+    if (entity == nullptr) {
+        return nullptr;
+    }
+
+    return getComponentInternal(*entity, componentID);
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+ecsBaseComponent* ecsWorld::getComponentInternal(const ecsEntity& entity, const ComponentID componentID) const {
+    for (const auto& [compId, fn, compHandle] : entity.m_components) {
+        if (componentID == compId) {
+            return locateComponent(compId, fn);
+        }
+    }
+    return nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+ecsBaseComponent* ecsWorld::getComponentInternal(
+    const std::vector<std::tuple<ComponentID, ComponentIndex, ComponentHandle>>& entityComponents,
+    ComponentDataSpace& mem_array, const ComponentID componentID) noexcept {
+    for (const auto& entityComponent : entityComponents) {
+        const auto& [compId, fn, compHandle] = entityComponent;
+        if (componentID == compId) {
+            return reinterpret_cast<ecsBaseComponent*>(&mem_array[getByteOffset(compId, fn)]);
+        }
+    }
+    return nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// updateSystems
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::updateSystems(ecsSystemList& systems, const double deltaTime) {
+    for (auto& system : systems) {
+        updateSystem(*system, deltaTime);
+    }
+    flushObservers();
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// updateSystem
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::updateSystem(ecsSystem& system, const double deltaTime) {
+    assertWritable();
+
+    // Systems may run at their own rate, so this update may run 0+ times
+    keepPlan(system.getComponentTypes());
+    auto stepTime = deltaTime;
+    const auto steps = system.advanceClock(deltaTime, stepTime);
+    for (size_t step = 0; step < steps; ++step) {
+        if (!resolveSingletons(system)) {
+            return;
+        }
+
+        const auto components = system.getTimeSlice() == 0ULL
+                                    ? getRelevantComponents(system.getComponentTypes(), nullptr, system.m_lastRunTick)
+                                    : getRelevantSlice(system);
+        if (!components.empty()) {
+            system.updateComponents(stepTime, components);
+        }
+
+        // Written types are marked before the tick advances, so only other systems see the writes
+        const auto& componentTypes = system.getComponentTypes();
+        for (const auto& writtenID : system.m_writtenTypes) {
+            for (size_t j = 0; j < componentTypes.size(); ++j) {
+                if (componentTypes[j].first != writtenID) {
+                    continue;
+                }
+                for (const auto& row : components) {
+                    if (row[j] != nullptr) {
+                        stampChanged(*row[j]);
+                    }
+                }
+            }
+        }
+        system.m_lastRunTick = m_changeTick++;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::updateSystem(
+    const double deltaTime, const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes,
+    const std::function<void(const double, const std::vector<std::vector<ecsBaseComponent*>>&)>& func) {
+    if (const auto components = getRelevantComponents(componentTypes); !components.empty()) {
+        func(deltaTime, components);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// getRelevantComponents
+///////////////////////////////////////////////////////////////////////////
+
+std::vector<std::vector<ecsBaseComponent*>> ecsWorld::getRelevantComponents(
+    const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes, QuerySlice* const slice,
+    const uint64_t since) const {
+    // Change filters are queried as required terms, their rows then checked against ticks
+    const auto filter = makeChangeFilter(componentTypes, since);
+    if (filter.m_columns.empty()) {
+        return queryRelevantComponents(componentTypes, slice, nullptr);
+    }
+
+    auto requiredTypes = componentTypes;
+    for (const auto& [column, added] : filter.m_columns) {
+        requiredTypes[column].second = ecsSystem::RequirementsFlag::REQUIRED;
+    }
+    return queryRelevantComponents(requiredTypes, slice, &filter);
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// queryRelevantComponents
+///////////////////////////////////////////////////////////////////////////
+
+std::vector<std::vector<ecsBaseComponent*>> ecsWorld::queryRelevantComponents(
+    const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes,
+    QuerySlice* const slice, const ChangeFilter* const filter) const {
+    if (componentTypes.empty()) {
+        return {};
+    }
+    if (m_recorder != nullptr) {
+        m_recorder->recordQuery(componentTypes);
+    }
+
+    std::vector<std::vector<ecsBaseComponent*>> components;
+    const auto componentTypesCount = componentTypes.size();
+    const auto query = makeQueryMasks(componentTypes);
+
+    // Bound the driving rows visited, reporting the driver when slicing
+    const auto sliceDriver = [slice](const ComponentID driverID, const size_t driverSize) {
+        if (slice == nullptr) {
+            return std::make_pair(size_t(0ULL), driverSize);
+        }
+        slice->m_driverID = driverID;
+        slice->m_driverSize = driverSize;
+        const auto first = std::min(slice->m_begin, driverSize);
+        return std::make_pair(first, first + std::min(slice->m_count, driverSize - first));
+    };
+
+    // Find the change summaries of a filtered driving column, whose unchanged chunks are skipped whole
+    const auto findChunkTicks = [&](const size_t driverIndex) -> const std::vector<uint64_t>* {
+        if (filter == nullptr) {
+            return nullptr;
+        }
+        const auto isDriver = [driverIndex](const auto& column) { return column.first == driverIndex; };
+        if (std::none_of(filter->m_columns.cbegin(), filter->m_columns.cend(), isDriver)) {
+            return nullptr;
+        }
+        const auto chunkTicks = m_chunkTicks.find(componentTypes[driverIndex].first);
+        return chunkTicks == m_chunkTicks.cend() ? nullptr : &chunkTicks->second;
+    };
+    const auto isChunkUnchanged = [&](const std::vector<uint64_t>* chunkTicks, const size_t row, const size_t first) {
+        if (chunkTicks == nullptr || (row != first && row % CHANGE_CHUNK_ROWS != 0ULL)) {
+            return false;
+        }
+        const auto chunk = row / CHANGE_CHUNK_ROWS;
+        return chunk < chunkTicks->size() && (*chunkTicks)[chunk] <= filter->m_since;
+    };
+
+    // Super simple procedure for system with 1 pooled component type
+    if (componentTypesCount == 1U && !query.m_filtered && isPooled(componentTypes.front().first)) {
+        const auto& componentID = componentTypes.front().first;
+        const auto& typeSize = std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]);
+        auto* mem_array = findPool(componentID);
+        const auto* tombstones = findTombstones(componentID);
+        const auto* chunkTicks = findChunkTicks(0ULL);
+        const auto [first, last] = sliceDriver(componentID, countActiveRows(componentID));
+        components.reserve(last - first);
+        for (size_t j = first * typeSize; j < last * typeSize; j += typeSize) {
+            if (isChunkUnchanged(chunkTicks, j / typeSize, first)) {
+                j = (j / typeSize / CHANGE_CHUNK_ROWS + 1ULL) * CHANGE_CHUNK_ROWS * typeSize - typeSize;
+                continue;
+            }
+            if (tombstones != nullptr && tombstones->isDead(j / typeSize)) {
+                continue;
+            }
+            std::vector<ecsBaseComponent*> row{ reinterpret_cast<ecsBaseComponent*>(&(*mem_array)[j]) };
+            if (filter == nullptr || filter->passes(row)) {
+                components.emplace_back(std::move(row));
+            }
+        }
+        return components;
+    }
+
+    // Accumulate component class data pointers, tags have no data
+    std::vector<ComponentDataSpace*> componentArrays;
+    componentArrays.reserve(componentTypesCount);
+    std::transform(
+        componentTypes.cbegin(), componentTypes.cend(), std::back_inserter(componentArrays), [&](const auto& type) {
+            return isTagID(type.first) ? nullptr : findPool(type.first);
+        });
+
+    // Resolve a column of an entity's row, filter terms stay empty and stored classes are probed
+    std::vector<ecsBaseComponent*> componentParam(componentTypesCount);
+    const auto resolveColumn = [&](const ecsEntity& entity, const size_t j) {
+        const auto& [componentID, componentFlag] = componentTypes[j];
+        if (componentFlag == ecsSystem::RequirementsFlag::EXCLUDE || isTagID(componentID)) {
+            componentParam[j] = nullptr;
+        } else if (componentArrays[j] != nullptr) {
+            componentParam[j] = getComponentInternal(entity.m_components, *componentArrays[j], componentID);
+        } else {
+            componentParam[j] = isPooled(componentID) ? nullptr : getComponentInternal(entity, componentID);
+        }
+    };
+
+    // Grouped procedure, pools share a leading range so rows are zipped
+    if (const auto* group = findGroupFor(componentTypes)) {
+        const auto requiredIndex = static_cast<size_t>(std::distance(
+            componentTypes.cbegin(), std::find_if(componentTypes.cbegin(), componentTypes.cend(), [](const auto& type) {
+                return type.second == ecsSystem::RequirementsFlag::REQUIRED;
+            })));
+        const auto needsEntity = group->m_componentIDs.size() != componentTypesCount;
+        const auto [first, last] = sliceDriver(componentTypes[requiredIndex].first, group->m_size);
+        components.reserve(last - first);
+
+        for (size_t i = first; i < last; ++i) {
+            for (size_t j = 0; j < componentTypesCount; ++j) {
+                const auto& [componentID, componentFlag] = componentTypes[j];
+                if (componentFlag == ecsSystem::RequirementsFlag::REQUIRED) {
+                    const auto& typeSize = std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]);
+                    componentParam[j] = reinterpret_cast<ecsBaseComponent*>(&(*componentArrays[j])[i * typeSize]);
+                }
+            }
+
+            // Non-grouped terms fall outside the group and are looked up
+            if (needsEntity) {
+                const auto* entity = findEntity(componentParam[requiredIndex]->m_entityHandle);
+                if (query.m_filtered && !query.matches(entity->m_signature)) {
+                    continue;
+                }
+                for (size_t j = 0; j < componentTypesCount; ++j) {
+                    if (componentTypes[j].second != ecsSystem::RequirementsFlag::REQUIRED) {
+                        resolveColumn(*entity, j);
+                    }
+                }
+            }
+            if (filter == nullptr || filter->passes(componentParam)) {
+                components.emplace_back(componentParam);
+            }
+        }
+        return components;
+    }
+
+    // Slices keep their previous driver, so their cursor stays meaningful
+    auto minSizeIndex = std::numeric_limits<size_t>::max();
+    if (slice != nullptr) {
+        for (size_t j = 0; j < componentTypesCount; ++j) {
+            if (componentTypes[j].first == slice->m_driverID && componentArrays[j] != nullptr &&
+                componentTypes[j].second == ecsSystem::RequirementsFlag::REQUIRED) {
+                minSizeIndex = j;
+            }
+        }
+    }
+    // Slices only follow pools, so their driver stays put between calls
+    auto estimate = std::numeric_limits<size_t>::max();
+    if (minSizeIndex == std::numeric_limits<size_t>::max()) {
+        const auto plan = planQuery(componentTypes, query, filter);
+        minSizeIndex = slice == nullptr ? plan.m_driverIndex : plan.m_poolIndex;
+        estimate = plan.m_estimate;
+    }
+
+    // Without any required component data, test every entity's signature
+    if (minSizeIndex == std::numeric_limits<size_t>::max()) {
+        // Slices resume from an entity rather than a position, which shifts as entities come and go
+        auto entityPos = m_entities.cbegin();
+        auto remaining = m_entities.size();
+        if (slice != nullptr) {
+            slice->m_driverID = -1;
+            slice->m_driverSize = m_entities.size();
+            if (slice->m_entityHandle.isValid()) {
+                entityPos = m_entities.lower_bound(slice->m_entityHandle);
+            }
+            remaining = slice->m_count;
+        }
+        components.reserve(std::min({ remaining, m_entities.size(), estimate }));
+        for (; entityPos != m_entities.cend() && remaining > 0ULL; ++entityPos, --remaining) {
+            const auto& entity = entityPos->second;
+            if (entity->m_enabled && query.matches(entity->m_signature)) {
+                for (size_t j = 0; j < componentTypesCount; ++j) {
+                    resolveColumn(*entity, j);
+                }
+                if (filter == nullptr || filter->passes(componentParam)) {
+                    components.emplace_back(componentParam);
+                }
+            }
+        }
+        if (slice != nullptr) {
+            slice->m_entityHandle = entityPos == m_entities.cend() ? EntityHandle() : entityPos->first;
+        }
+        return components;
+    }
+
+    // More complex procedure for system with > 1 component type
+    const auto minComponentID = std::get<0>(componentTypes[minSizeIndex]);
+    const auto& typeSize = std::get<2>(ecsBaseComponent::m_componentRegistry[minComponentID]);
+    auto* mem_array = componentArrays[minSizeIndex];
+    const auto* tombstones = findTombstones(minComponentID);
+    const auto* chunkTicks = findChunkTicks(minSizeIndex);
+    const auto [first, last] = sliceDriver(minComponentID, countActiveRows(minComponentID));
+    components.reserve(std::min(last - first, estimate));
+
+    // Find all relevant components, rejecting unchanged chunks, tombstones then entities by signature
+    for (size_t i = first * typeSize; i < last * typeSize; i += typeSize) {
+        if (isChunkUnchanged(chunkTicks, i / typeSize, first)) {
+            i = (i / typeSize / CHANGE_CHUNK_ROWS + 1ULL) * CHANGE_CHUNK_ROWS * typeSize - typeSize;
+            continue;
+        }
+        if (tombstones != nullptr && tombstones->isDead(i / typeSize)) {
+            continue;
+        }
+        componentParam[minSizeIndex] = reinterpret_cast<ecsBaseComponent*>(&(*mem_array)[i]);
+        const auto* entity = findEntity(componentParam[minSizeIndex]->m_entityHandle);
+        if (entity == nullptr || !query.matches(entity->m_signature)) {
+            continue;
+        }
+
+        for (size_t j = 0; j < componentTypesCount; ++j) {
+            if (j != minSizeIndex) {
+                resolveColumn(*entity, j);
+            }
+        }
+        if (filter == nullptr || filter->passes(componentParam)) {
+            components.emplace_back(componentParam);
+        }
+    }
+    return components;
 }
 
+///////////////////////////////////////////////////////////////////////////
+/// getRelevantSlice
 ///////////////////////////////////////////////////////////////////////////
 
-void ecsWorld::removeComponentInternal(const ComponentID componentID, const ComponentID index) {
-    if (isComponentIDValid(componentID)) {
-        auto& mem_array = m_components[componentID];
-        const auto& [createFn, freeFn, typeSize] = ecsBaseComponent::m_componentRegistry[componentID];
-        const auto srcIndex = mem_array.size() - typeSize;
+std::vector<std::vector<ecsBaseComponent*>> ecsWorld::getRelevantSlice(ecsSystem& system) {
+    // Follow the next entity to its current driving row, it may have moved
+    auto& cursor = system.m_cursor;
+    if (cursor.m_entityHandle.isValid() && isComponentIDValid(cursor.m_driverID)) {
+        if (const auto entity = getEntity(cursor.m_entityHandle)) {
+            for (const auto& [compID, fn, compHandle] : entity->m_components) {
+                if (compID == cursor.m_driverID) {
+                    cursor.m_index = static_cast<size_t>(fn);
+                    break;
+                }
+            }
+        }
+    }
 
-        const auto* srcComponent = reinterpret_cast<ecsBaseComponent*>(&mem_array[srcIndex]);
-        auto* destComponent = reinterpret_cast<ecsBaseComponent*>(&mem_array[index]);
-        freeFn(destComponent);
+    // Each row is visited once per pass, so changes are reported since the previous pass began
+    if (cursor.m_index == 0ULL) {
+        system.m_passSinceTick = system.m_passStartTick;
+        system.m_passStartTick = system.m_lastRunTick;
+    }
 
-        if (static_cast<size_t>(index) == srcIndex) {
-            mem_array.resize(srcIndex);
-            return;
+    QuerySlice slice{ cursor.m_index, system.getTimeSlice(), cursor.m_driverID, 0ULL, cursor.m_entityHandle };
+    auto components = getRelevantComponents(system.getComponentTypes(), &slice, system.m_passSinceTick);
+
+    // Without a driving pool the query hands back the next entity, counting rows only marks a pass begun
+    cursor.m_driverID = slice.m_driverID;
+    if (!isComponentIDValid(cursor.m_driverID)) {
+        cursor.m_entityHandle = slice.m_entityHandle;
+        cursor.m_index = cursor.m_entityHandle.isValid() ? cursor.m_index + slice.m_count : 0ULL;
+        return components;
+    }
+
+    // Advance the cursor, wrapping around after a full pass
+    cursor.m_index = std::min(slice.m_begin, slice.m_driverSize) + slice.m_count;
+    cursor.m_entityHandle = EntityHandle();
+    if (cursor.m_index >= slice.m_driverSize) {
+        cursor.m_index = 0ULL;
+    } else {
+        // A tombstoned row has no owner to follow, the cursor keeps its index instead
+        const auto* tombstones = findTombstones(cursor.m_driverID);
+        if (tombstones == nullptr || !tombstones->isDead(cursor.m_index)) {
+            const auto& typeSize = std::get<2>(ecsBaseComponent::m_componentRegistry[cursor.m_driverID]);
+            cursor.m_entityHandle =
+                reinterpret_cast<ecsBaseComponent*>(&(*findPool(cursor.m_driverID))[cursor.m_index * typeSize])
+                    ->m_entityHandle;
         }
-        std::memcpy(static_cast<void*>(destComponent), static_cast<const void*>(srcComponent), typeSize);
+    }
+    return components;
+}
 
-        // Update references
-        for (auto& component : getEntity(srcComponent->m_entityHandle)->m_components) {
-            auto& [compID, fn, compHandle] = component;
-            if (componentID == compID && static_cast<ComponentID>(srcIndex) == fn) {
-                fn = index;
-                break;
-            }
+///////////////////////////////////////////////////////////////////////////
+/// findLeastCommonComponent
+///////////////////////////////////////////////////////////////////////////
+
+size_t ecsWorld::findLeastCommonComponent(
+    const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes) const {
+    size_t minSize = std::numeric_limits<size_t>::max();
+    size_t minIndex = std::numeric_limits<size_t>::max();
+    const auto componentTypesCount = componentTypes.size();
+
+    for (size_t index = 0; index < componentTypesCount; ++index) {
+        const auto& [componentID, componentFlag] = componentTypes[index];
+        if ((componentFlag != ecsSystem::RequirementsFlag::REQUIRED &&
+             componentFlag != ecsSystem::RequirementsFlag::CHANGED &&
+             componentFlag != ecsSystem::RequirementsFlag::ADDED) ||
+            isTagID(componentID) || !isPooled(componentID)) {
+            continue;
+        }
+
+        const auto size = countActiveRows(componentID);
+        if (size <= minSize) {
+            minSize = size;
+            minIndex = index;
         }
-        mem_array.resize(srcIndex);
     }
+    return minIndex;
 }
 
 ///////////////////////////////////////////////////////////////////////////
-/// getComponentInternal
+/// estimateMatches
 ///////////////////////////////////////////////////////////////////////////
 
-ecsBaseComponent* ecsWorld::getComponentInternal(const EntityHandle& entityHandle, const ComponentID componentID) {
-    const auto entity = getEntity(entityHandle);
-    if (entity == nullptr) {
-        return nullptr;
+size_t ecsWorld::estimateMatches(
+    const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes) const {
+    return countMatches(makeQueryMasks(componentTypes));
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// getQueryDriver
+///////////////////////////////////////////////////////////////////////////
+
+ComponentID ecsWorld::getQueryDriver(
+    const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes,
+    const uint64_t since) const {
+    const auto filter = makeChangeFilter(componentTypes, since);
+    auto requiredTypes = componentTypes;
+    for (const auto& [column, added] : filter.m_columns) {
+        requiredTypes[column].second = ecsSystem::RequirementsFlag::REQUIRED;
     }
+    const auto plan =
+        planQuery(requiredTypes, makeQueryMasks(componentTypes), filter.m_columns.empty() ? nullptr : &filter);
+    return plan.m_driverIndex == std::numeric_limits<size_t>::max() ? ComponentID(-1)
+                                                                    : componentTypes[plan.m_driverIndex].first;
+}
 
-    return getComponentInternal(*entity, componentID);
+///////////////////////////////////////////////////////////////////////////
+/// countMatches
+///////////////////////////////////////////////////////////////////////////
+
+size_t ecsWorld::countMatches(const QueryMasks& query) const {
+    // Distinct signatures are few, so this is far cheaper than visiting entities
+    size_t matches(0ULL);
+    for (const auto& [signature, count] : m_census) {
+        if (query.matches(signature)) {
+            matches += count;
+        }
+    }
+    return matches;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// planQuery
+///////////////////////////////////////////////////////////////////////////
+
+ecsWorld::QueryPlan ecsWorld::planQuery(
+    const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes,
+    const QueryMasks& query, const ChangeFilter* const filter) const {
+    // Plans are kept under the query as written, as filter terms change the plan
+    const auto& plannedTypes = filter == nullptr ? componentTypes : *filter->m_componentTypes;
+    const auto kept = m_plans.find(plannedTypes);
+    auto plan = kept != m_plans.cend() ? kept->second : makePlan(plannedTypes, query);
+    if (filter == nullptr) {
+        return plan;
+    }
+
+    // A filtered pool skips its unchanged chunks whole, so it may drive far fewer rows than any other
+    auto cost = plan.m_driverIndex == std::numeric_limits<size_t>::max()
+                    ? estimateScanCost()
+                    : estimateDriveCost(countActiveRows(componentTypes[plan.m_driverIndex].first));
+    for (const auto& [column, added] : filter->m_columns) {
+        const auto& componentID = componentTypes[column].first;
+        if (isTagID(componentID) || !isPooled(componentID)) {
+            continue;
+        }
+        if (const auto filteredCost = estimateDriveCost(countChangedRows(componentID, filter->m_since));
+            filteredCost < cost) {
+            cost = filteredCost;
+            plan.m_driverIndex = column;
+        }
+    }
+    return plan;
 }
 
+///////////////////////////////////////////////////////////////////////////
+/// makePlan
 ///////////////////////////////////////////////////////////////////////////
 
-ecsBaseComponent* mini::ecsWorld::getComponentInternal(ecsEntity& entity, const ComponentID componentID) {
-    return getComponentInternal(entity.m_components, m_components[componentID], componentID);
+ecsWorld::QueryPlan ecsWorld::makePlan(
+    const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes,
+    const QueryMasks& query) const {
+    QueryPlan plan;
+    plan.m_poolIndex = findLeastCommonComponent(componentTypes);
+    plan.m_driverIndex = plan.m_poolIndex;
+    plan.m_estimate = countMatches(query);
+    if (plan.m_poolIndex == std::numeric_limits<size_t>::max()) {
+        return plan;
+    }
+
+    // Driving keeps pool order and skips whole chunks, so the scan is only chosen when it costs less outright
+    if (estimateDriveCost(countActiveRows(componentTypes[plan.m_poolIndex].first)) > estimateScanCost()) {
+        plan.m_driverIndex = std::numeric_limits<size_t>::max();
+    }
+    return plan;
 }
 
+///////////////////////////////////////////////////////////////////////////
+/// estimateDriveCost
 ///////////////////////////////////////////////////////////////////////////
 
-ecsBaseComponent* ecsWorld::getComponentInternal(
-    const std::vector<std::tuple<ComponentID, int, ComponentHandle>>& entityComponents, ComponentDataSpace& mem_array,
-    const ComponentID componentID) noexcept {
-    for (const auto& entityComponent : entityComponents) {
-        const auto& [compId, fn, compHandle] = entityComponent;
-        if (componentID == compId) {
-            return reinterpret_cast<ecsBaseComponent*>(&mem_array[fn]);
+size_t ecsWorld::estimateDriveCost(const size_t rows) const noexcept {
+    // A scan steps to every entity and loads its signature, while a driving row's lookup only misses below the
+    // tree's upper levels, which stay cached across rows
+    constexpr size_t cachedLevels = 10ULL;
+    size_t levels(0ULL);
+    for (auto count = m_entities.size(); count > 1ULL; count >>= 1ULL) {
+        ++levels;
+    }
+    return rows * (1ULL + (levels > cachedLevels ? levels - cachedLevels : 0ULL));
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// countChangedRows
+///////////////////////////////////////////////////////////////////////////
+
+size_t ecsWorld::countChangedRows(const ComponentID componentID, const uint64_t since) const {
+    const auto activeRows = countActiveRows(componentID);
+    const auto chunkTicks = m_chunkTicks.find(componentID);
+    if (chunkTicks == m_chunkTicks.cend()) {
+        return activeRows;
+    }
+
+    // Chunks without a summary are visited, as they may hold changes
+    size_t unchangedRows(0ULL);
+    const auto& ticks = chunkTicks->second;
+    for (size_t chunk = 0; chunk < ticks.size() && chunk * CHANGE_CHUNK_ROWS < activeRows; ++chunk) {
+        if (ticks[chunk] <= since) {
+            unchangedRows += std::min(CHANGE_CHUNK_ROWS, activeRows - chunk * CHANGE_CHUNK_ROWS);
         }
     }
-    return nullptr;
+    return activeRows - unchangedRows;
 }
 
 ///////////////////////////////////////////////////////////////////////////
-/// updateSystems
+/// keepPlan
 ///////////////////////////////////////////////////////////////////////////
 
-void ecsWorld::updateSystems(ecsSystemList& systems, const double deltaTime) {
-    for (auto& system : systems) {
-        updateSystem(*system, deltaTime);
+void ecsWorld::keepPlan(const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes) {
+    if (m_plans.find(componentTypes) != m_plans.end()) {
+        return;
+    }
+
+    if (m_plans.empty()) {
+        m_plannedEntities = m_entities.size();
+    }
+    m_plans.emplace(componentTypes, makePlan(componentTypes, makeQueryMasks(componentTypes)));
+    for (const auto& [componentID, componentFlag] : componentTypes) {
+        if (componentFlag != ecsSystem::RequirementsFlag::OPTIONAL &&
+            componentFlag != ecsSystem::RequirementsFlag::EXCLUDE &&
+            componentFlag != ecsSystem::RequirementsFlag::ANY && !isTagID(componentID) && isPooled(componentID)) {
+            m_plannedRows.emplace(componentID, countActiveRows(componentID));
+        }
     }
 }
 
 ///////////////////////////////////////////////////////////////////////////
-/// updateSystem
+/// refreshPlans
 ///////////////////////////////////////////////////////////////////////////
 
-void ecsWorld::updateSystem(ecsSystem& system, const double deltaTime) {
-    if (const auto components = getRelevantComponents(system.getComponentTypes()); !components.empty()) {
-        system.updateComponents(deltaTime, components);
+void ecsWorld::refreshPlans(const ComponentID componentID) {
+    if (m_plans.empty()) {
+        return;
+    }
+
+    // Small changes never re-plan, so churn around a steady size leaves plans alone
+    const auto drifted = [](const size_t planned, const size_t current) {
+        constexpr size_t slack = 16ULL;
+        return current > planned * 2ULL + slack || planned > current * 2ULL + slack;
+    };
+    const auto plannedRows = m_plannedRows.find(componentID);
+    if (!drifted(m_plannedEntities, m_entities.size()) &&
+        (plannedRows == m_plannedRows.end() || !drifted(plannedRows->second, countActiveRows(componentID)))) {
+        return;
+    }
+
+    m_plannedEntities = m_entities.size();
+    for (auto& [plannedID, rows] : m_plannedRows) {
+        rows = countActiveRows(plannedID);
+    }
+    for (auto& [componentTypes, plan] : m_plans) {
+        plan = makePlan(componentTypes, makeQueryMasks(componentTypes));
     }
 }
 
+///////////////////////////////////////////////////////////////////////////
+/// sortRows
 ///////////////////////////////////////////////////////////////////////////
 
-void ecsWorld::updateSystem(
-    const double deltaTime, const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes,
-    const std::function<void(const double, const std::vector<std::vector<ecsBaseComponent*>>&)>& func) {
-    if (const auto components = getRelevantComponents(componentTypes); !components.empty()) {
-        func(deltaTime, components);
+void ecsWorld::sortRows(
+    const std::vector<uint64_t>& keys, std::vector<size_t>& permutation, SortOrder* const order) {
+    // Start from the kept order while it covers the same number of rows
+    if (order != nullptr && !keys.empty() && order->m_permutation.size() == keys.size()) {
+        permutation = order->m_permutation;
+        if (resortRows(keys, permutation)) {
+            ++order->m_incrementalSorts;
+            order->m_permutation = permutation;
+            return;
+        }
+    }
+
+    radixSortRows(keys, permutation);
+    if (order != nullptr) {
+        ++order->m_fullSorts;
+        order->m_permutation = permutation;
     }
 }
 
 ///////////////////////////////////////////////////////////////////////////
-/// getRelevantComponents
+/// radixSortRows
 ///////////////////////////////////////////////////////////////////////////
 
-std::vector<std::vector<ecsBaseComponent*>> ecsWorld::getRelevantComponents(
-    const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes) {
-    if (componentTypes.empty()) {
-        return {};
+void ecsWorld::radixSortRows(const std::vector<uint64_t>& keys, std::vector<size_t>& permutation) {
+    const auto rowCount = keys.size();
+    permutation.resize(rowCount);
+    for (size_t i = 0; i < rowCount; ++i) {
+        permutation[i] = i;
     }
 
-    std::vector<std::vector<ecsBaseComponent*>> components;
-    const auto componentTypesCount = componentTypes.size();
-    // Super simple procedure for system with 1 component type
-    if (componentTypesCount == 1U) {
-        const auto& componentID = componentTypes.front().first;
-        const auto& typeSize = std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]);
-        auto& mem_array = m_components[componentID];
-        const auto mem_arraySize = mem_array.size();
-        components.reserve(mem_arraySize / typeSize);
-        for (size_t j = 0; j < mem_arraySize; j += typeSize) {
-            components.emplace_back(
-                std::vector<ecsBaseComponent*>{ reinterpret_cast<ecsBaseComponent*>(&mem_array[j]) });
+    // Counting passes don't pay off for a handful of rows
+    constexpr size_t smallCount = 64ULL;
+    if (rowCount < smallCount) {
+        std::stable_sort(permutation.begin(), permutation.end(), [&keys](const size_t a, const size_t b) {
+            return keys[a] < keys[b];
+        });
+        return;
+    }
+
+    // Only bytes that differ between keys need a pass, so small keys take one or two
+    uint64_t anyBits(0ULL);
+    uint64_t allBits(~0ULL);
+    for (const auto& key : keys) {
+        anyBits |= key;
+        allBits &= key;
+    }
+    const auto varyingBits = anyBits ^ allBits;
+
+    // Keys travel with their rows to keep each pass sequential
+    std::vector<std::pair<uint64_t, size_t>> items(rowCount);
+    std::vector<std::pair<uint64_t, size_t>> scratch(rowCount);
+    for (size_t i = 0; i < rowCount; ++i) {
+        items[i] = { keys[i], i };
+    }
+    for (auto shift = 0U; shift < 64U; shift += 8U) {
+        if (((varyingBits >> shift) & 0xFFULL) == 0ULL) {
+            continue;
+        }
+
+        std::array<size_t, 257> offsets{};
+        for (const auto& item : items) {
+            ++offsets[((item.first >> shift) & 0xFFULL) + 1ULL];
+        }
+        for (size_t digit = 1; digit < offsets.size(); ++digit) {
+            offsets[digit] += offsets[digit - 1ULL];
         }
+        for (const auto& item : items) {
+            scratch[offsets[(item.first >> shift) & 0xFFULL]++] = item;
+        }
+        items.swap(scratch);
     }
-    // More complex procedure for system with > 1 component type
-    else {
-        // Accumulate component class data pointers
-        std::vector<ComponentDataSpace*> componentArrays;
-        componentArrays.reserve(componentTypesCount);
-        std::transform(
-            componentTypes.cbegin(), componentTypes.cend(), std::back_inserter(componentArrays),
-            [&](const auto& type) { return &m_components[std::get<0>(type)]; });
-
-        const auto minSizeIndex = findLeastCommonComponent(componentTypes);
-        const auto minComponentID = std::get<0>(componentTypes[minSizeIndex]);
-        const auto& typeSize = std::get<2>(ecsBaseComponent::m_componentRegistry[minComponentID]);
-        auto& mem_array = *componentArrays[minSizeIndex];
-        const auto mem_arraySize = mem_array.size();
-        components.reserve(mem_arraySize / typeSize);
-
-        // Find all relevant components, store in componentParam
-        std::vector<ecsBaseComponent*> componentParam(componentTypesCount);
-        for (size_t i = 0; i < mem_arraySize; i += typeSize) {
-            componentParam[minSizeIndex] = reinterpret_cast<ecsBaseComponent*>(&mem_array[i]);
-            const auto entity = getEntity(componentParam[minSizeIndex]->m_entityHandle);
-            if (entity == nullptr) {
-                continue;
-            }
+    for (size_t i = 0; i < rowCount; ++i) {
+        permutation[i] = items[i].second;
+    }
+}
 
-            const auto& entityComponents = entity->m_components;
-            bool isValid = true;
-            for (size_t j = 0; j < componentTypesCount; ++j) {
-                if (j == minSizeIndex) {
-                    continue;
-                }
+///////////////////////////////////////////////////////////////////////////
+/// resortRows
+///////////////////////////////////////////////////////////////////////////
 
-                const auto& [componentID, componentFlag] = componentTypes[j];
-                componentParam[j] = getComponentInternal(entityComponents, *componentArrays[j], componentID);
-                if (componentParam[j] == nullptr && componentFlag == ecsSystem::RequirementsFlag::REQUIRED) {
-                    isValid = false;
-                    break;
-                }
+bool ecsWorld::resortRows(const std::vector<uint64_t>& keys, std::vector<size_t>& permutation) noexcept {
+    // Rows that moved a little cost a few moves, too many moves means a full sort is cheaper
+    auto budget = permutation.size();
+    for (size_t i = 1; i < permutation.size(); ++i) {
+        const auto row = permutation[i];
+        const auto key = keys[row];
+        auto position = i;
+        const auto isAfter = [&](const size_t other) {
+            return keys[other] > key || (keys[other] == key && other > row);
+        };
+        for (; position > 0ULL && isAfter(permutation[position - 1ULL]); --position) {
+            if (budget-- == 0ULL) {
+                return false;
             }
-            if (isValid) {
-                components.emplace_back(componentParam);
+            permutation[position] = permutation[position - 1ULL];
+        }
+        permutation[position] = row;
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// forEachChunk
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::forEachChunk(
+    const size_t chunkCount, const size_t threadCount, const std::function<void(const size_t)>& work) {
+    // Chunks are claimed one at a time, so uneven chunks balance themselves
+    std::atomic<size_t> nextChunk(0ULL);
+    const auto runChunks = [&]() {
+        for (auto chunk = nextChunk.fetch_add(1ULL); chunk < chunkCount; chunk = nextChunk.fetch_add(1ULL)) {
+            work(chunk);
+        }
+    };
+
+    // The calling thread always works, helpers are only spawned for spare chunks
+    std::vector<std::thread> helpers;
+    const auto helperCount = std::min(std::max<size_t>(threadCount, 1ULL), chunkCount);
+    for (size_t i = 1; i < helperCount; ++i) {
+        helpers.emplace_back(runChunks);
+    }
+    runChunks();
+    for (auto& helper : helpers) {
+        helper.join();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// insertEntity
+///////////////////////////////////////////////////////////////////////////
+
+ecsEntity& ecsWorld::insertEntity(ecsEntity&& entity) {
+    ++m_census[entity.m_signature];
+    const auto entityHandle = entity.m_handle;
+    auto& inserted =
+        *m_entities.insert_or_assign(entityHandle, std::make_shared<ecsEntity>(std::move(entity))).first->second;
+    for (const auto& [componentID, index, componentHandle] : inserted.m_components) {
+        refreshPlans(componentID);
+    }
+
+    // Entities may arrive with tags and components, which are logged as made here
+    if (m_recorder != nullptr) {
+        m_recorder->recordEntity(ecsTraceRecorder::Operation::MAKE_ENTITY, entityHandle);
+        for (ComponentID tagID = 0; tagID < static_cast<ComponentID>(ecsBaseComponent::m_componentRegistry.size());
+             ++tagID) {
+            if (isTagID(tagID) && inserted.m_signature.test(tagID)) {
+                m_recorder->recordType(ecsTraceRecorder::Operation::SET_TAG, entityHandle, tagID, true);
             }
         }
+        for (const auto& [componentID, index, componentHandle] : inserted.m_components) {
+            m_recorder->recordType(ecsTraceRecorder::Operation::MAKE_COMPONENT, entityHandle, componentID);
+        }
     }
-    return components;
+    return inserted;
 }
 
 ///////////////////////////////////////////////////////////////////////////
-/// findLeastCommonComponent
+/// setSignatureBit
 ///////////////////////////////////////////////////////////////////////////
 
-size_t ecsWorld::findLeastCommonComponent(
-    const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes) {
-    size_t minSize = std::numeric_limits<size_t>::max();
-    size_t minIndex = std::numeric_limits<size_t>::max();
-    size_t index(0ULL);
+void ecsWorld::setSignatureBit(ecsEntity& entity, const ComponentID componentID, const bool value) {
+    if (entity.m_signature.test(componentID) == value) {
+        return;
+    }
 
-    for (const auto& [componentID, componentFlag] : componentTypes) {
-        if (componentFlag == ecsSystem::RequirementsFlag::OPTIONAL) {
-            continue;
+    // Zero counts are kept, as entities tend to revisit the same signatures
+    if (const auto count = m_census.find(entity.m_signature); count != m_census.end()) {
+        --count->second;
+    }
+    if (value) {
+        entity.m_signature.set(componentID);
+    } else {
+        entity.m_signature.reset(componentID);
+    }
+    ++m_census[entity.m_signature];
+    refreshPlans(componentID);
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// countActiveRows
+///////////////////////////////////////////////////////////////////////////
+
+size_t ecsWorld::countActiveRows(const ComponentID componentID) const noexcept {
+    const auto* mem_array = findPool(componentID);
+    if (mem_array == nullptr) {
+        return 0ULL;
+    }
+
+    const auto& typeSize = std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]);
+    const auto disabled = m_disabledCounts.find(componentID);
+    return mem_array->size() / typeSize - (disabled == m_disabledCounts.end() ? 0ULL : disabled->second);
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// activateRow
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::activateRow(const ComponentID componentID, const size_t index) {
+    if (!isPooled(componentID)) {
+        return;
+    }
+
+    // Trade places with the tail's first row, then shrink the tail past it
+    const auto& typeSize = std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]);
+    swapComponents(componentID, index, countActiveRows(componentID) * typeSize);
+    --m_disabledCounts[componentID];
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// deactivateRow
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::deactivateRow(const ComponentID componentID, const size_t index) {
+    if (!isPooled(componentID)) {
+        return;
+    }
+
+    // Trade places with the last active row, then grow the tail over it
+    const auto& typeSize = std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]);
+    swapComponents(componentID, index, countActiveRows(componentID) * typeSize - typeSize);
+    ++m_disabledCounts[componentID];
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// recordAdded
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::recordAdded(const ecsEntity& entity, const ComponentID componentID) {
+    // Only the type just added can complete an observer's signature
+    for (auto& state : m_observers) {
+        if (state.m_signature.test(componentID) && entity.m_signature.containsAll(state.m_signature)) {
+            state.m_events.emplace_back(entity.m_handle, true);
         }
+    }
+}
 
-        const auto& typeSize = std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]);
-        const auto size = m_components[componentID].size() / typeSize;
-        if (size <= minSize) {
-            minSize = size;
-            minIndex = index;
+///////////////////////////////////////////////////////////////////////////
+/// recordRemoved
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::recordRemoved(const ecsEntity& entity, const ComponentID componentID) {
+    // Only the type being removed can break an observer's signature
+    for (auto& state : m_observers) {
+        if (state.m_signature.test(componentID) && entity.m_signature.containsAll(state.m_signature)) {
+            state.m_events.emplace_back(entity.m_handle, false);
         }
-        ++index;
     }
-    return minIndex;
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorld::recordRemoved(const ecsEntity& entity) {
+    for (auto& state : m_observers) {
+        if (entity.m_signature.containsAll(state.m_signature)) {
+            state.m_events.emplace_back(entity.m_handle, false);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// makeChangeFilter
+///////////////////////////////////////////////////////////////////////////
+
+ecsWorld::ChangeFilter ecsWorld::makeChangeFilter(
+    const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes, const uint64_t since) {
+    ChangeFilter filter{ {}, since, &componentTypes };
+    for (size_t j = 0; j < componentTypes.size(); ++j) {
+        const auto& componentFlag = componentTypes[j].second;
+        if (componentFlag == ecsSystem::RequirementsFlag::CHANGED ||
+            componentFlag == ecsSystem::RequirementsFlag::ADDED) {
+            filter.m_columns.emplace_back(j, componentFlag == ecsSystem::RequirementsFlag::ADDED);
+        }
+    }
+    return filter;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// makeQueryMasks
+///////////////////////////////////////////////////////////////////////////
+
+ecsWorld::QueryMasks
+ecsWorld::makeQueryMasks(const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes) {
+    QueryMasks query;
+    for (const auto& [componentID, componentFlag] : componentTypes) {
+        switch (componentFlag) {
+        case ecsSystem::RequirementsFlag::REQUIRED:
+        case ecsSystem::RequirementsFlag::CHANGED:
+        case ecsSystem::RequirementsFlag::ADDED:
+            query.m_required.set(componentID);
+            query.m_filtered = query.m_filtered || isTagID(componentID);
+            break;
+        case ecsSystem::RequirementsFlag::OPTIONAL:
+            break;
+        case ecsSystem::RequirementsFlag::EXCLUDE:
+            query.m_excluded.set(componentID);
+            query.m_filtered = true;
+            break;
+        case ecsSystem::RequirementsFlag::ANY:
+            query.m_any.set(componentID);
+            query.m_filtered = true;
+            break;
+        }
+    }
+    return query;
 }
\ No newline at end of file
@@ -2,12 +2,30 @@
 #ifndef MINIECS_ECSWORLD_HPP
 #define MINIECS_ECSWORLD_HPP
 
+#include "ecsColdStore.hpp"
 #include "ecsComponent.hpp"
 #include "ecsEntity.hpp"
+#include "ecsEventChannel.hpp"
 #include "ecsHandle.hpp"
+#include "ecsObserver.hpp"
+#include "ecsSnapshot.hpp"
+#include "ecsSpawnBuffer.hpp"
 #include "ecsSystem.hpp"
+#include "ecsTrace.hpp"
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <set>
+#include <thread>
+#include <typeindex>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace mini {
 ///////////////////////////////////////////////////////////////////////////
@@ -18,11 +36,86 @@ using ComponentMap = std::map<ComponentID, ComponentDataSpace>;
 ///////////////////////////////////////////////////////////////////////////
 /// \class  ecsWorld
 /// \brief  A set of ECS entities and components forming a single level.
+/// \note   Const member functions never modify the world, so any number of
+///         threads may call them concurrently. No thread may call a non-const
+///         member function meanwhile, which beginReadPhase checks in debug.
 class ecsWorld {
     public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Where an entity's data currently lives.
+    enum class Residency {
+        RESIDENT,
+        EVICTED,
+        UNKNOWN,
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \class  ReadPhase
+    /// \brief  Marks a span of concurrent read-only access to a world.
+    class ReadPhase final {
+        public:
+        ///////////////////////////////////////////////////////////////////////////
+        /// \brief  End this read phase.
+        ~ReadPhase() {
+            if (m_world != nullptr) {
+                m_world->m_readers.fetch_sub(1ULL, std::memory_order_release);
+            }
+        }
+        ///////////////////////////////////////////////////////////////////////////
+        /// \brief  Move a read phase.
+        /// \param	other				another read phase to move to here.
+        ReadPhase(ReadPhase&& other) noexcept : m_world(other.m_world) { other.m_world = nullptr; }
+
+        private:
+        ///////////////////////////////////////////////////////////////////////////
+        /// \brief  Begin a read phase on a world.
+        /// \param	world				the world to read from.
+        explicit ReadPhase(const ecsWorld& world) noexcept : m_world(&world) {
+            m_world->m_readers.fetch_add(1ULL, std::memory_order_acquire);
+        }
+        ///////////////////////////////////////////////////////////////////////////
+        /// \brief  Disallow copying a read phase.
+        ReadPhase(const ReadPhase&) = delete;
+        ///////////////////////////////////////////////////////////////////////////
+        /// \brief  Disallow read phase assignment.
+        ReadPhase& operator=(const ReadPhase&) = delete;
+
+        const ecsWorld* m_world = nullptr; ///< The world being read.
+        friend class ecsWorld;             ///< Allows the ecsWorld to begin phases.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \class  SortOrder
+    /// \brief  The row order of a sorted query, kept between calls so that rows
+    ///         whose keys barely changed are re-sorted incrementally.
+    /// \note   Rows with equal keys keep their query order, however they're sorted.
+    class SortOrder final {
+        public:
+        ///////////////////////////////////////////////////////////////////////////
+        /// \brief  Forget the kept order, so the next sort starts over.
+        void clear() noexcept { m_permutation.clear(); }
+        ///////////////////////////////////////////////////////////////////////////
+        /// \brief  Retrieve the number of sorts made from scratch.
+        /// \return	the number of full radix sorts.
+        [[nodiscard]] size_t getFullSortCount() const noexcept { return m_fullSorts; }
+        ///////////////////////////////////////////////////////////////////////////
+        /// \brief  Retrieve the number of sorts made from the kept order.
+        /// \return	the number of incremental sorts.
+        [[nodiscard]] size_t getIncrementalSortCount() const noexcept { return m_incrementalSorts; }
+
+        private:
+        std::vector<size_t> m_permutation; ///< Query row at each sorted position.
+        size_t m_fullSorts = 0ULL;         ///< Sorts made from scratch.
+        size_t m_incrementalSorts = 0ULL;  ///< Sorts made from the kept order.
+        friend class ecsWorld;             ///< Allows the ecsWorld to sort.
+    };
+
     ///////////////////////////////////////////////////////////////////////////
     /// \brief  Destroy this ECS World.
-    ~ecsWorld() { clear(); }
+    ~ecsWorld() {
+        m_recorder = nullptr;
+        clear();
+    }
     ///////////////////////////////////////////////////////////////////////////
     /// \brief  Construct an empty ECS World.
     ecsWorld() {}
@@ -30,7 +123,18 @@ class ecsWorld {
     /// \brief  Move an ECS world.
     /// \param	other				another ecsWorld to move to here.
     ecsWorld(ecsWorld&& other) noexcept
-        : m_components(std::move(other.m_components)), m_entities(std::move(other.m_entities)) {}
+        : m_components(std::move(other.m_components)), m_stores(std::move(other.m_stores)),
+          m_entities(std::move(other.m_entities)), m_groups(std::move(other.m_groups)),
+          m_singletons(std::move(other.m_singletons)), m_sharedComponents(std::move(other.m_sharedComponents)),
+          m_observers(std::move(other.m_observers)), m_bufferedTypes(std::move(other.m_bufferedTypes)),
+          m_snapshots(std::move(other.m_snapshots)), m_frontSnapshot(other.m_frontSnapshot),
+          m_flipCount(other.m_flipCount), m_disabledCounts(std::move(other.m_disabledCounts)),
+          m_tombstones(std::move(other.m_tombstones)), m_tombstoneMode(other.m_tombstoneMode),
+          m_compactionCursor(other.m_compactionCursor), m_chunkTicks(std::move(other.m_chunkTicks)),
+          m_changeTick(other.m_changeTick), m_structuralVersions(std::move(other.m_structuralVersions)),
+          m_evicted(std::move(other.m_evicted)), m_census(std::move(other.m_census)), m_plans(std::move(other.m_plans)),
+          m_plannedRows(std::move(other.m_plannedRows)), m_plannedEntities(other.m_plannedEntities),
+          m_eventChannels(std::move(other.m_eventChannels)), m_recorder(std::exchange(other.m_recorder, nullptr)) {}
 
     ///////////////////////////////////////////////////////////////////////////
     /// \brief  Move the data from another ecsWorld into this.
@@ -74,11 +178,13 @@ class ecsWorld {
 
     ///////////////////////////////////////////////////////////////////////////
     /// \brief  Search for and remove an entity matching the specific handle.
+    /// \note   Any children of the entity are removed along with it.
     /// \param	entityHandle		handle to the entity to be removed.
     /// \return	true on successful removal, false otherwise.
     bool removeEntity(const EntityHandle& entityHandle);
     ///////////////////////////////////////////////////////////////////////////
     /// \brief  Remove the entity specified.
+    /// \note   Any children of the entity are removed along with it.
     /// \param	entity		        the entity to be removed.
     /// \return	true on successful removal, false otherwise.
     bool removeEntity(ecsEntity& entity);
@@ -101,6 +207,91 @@ class ecsWorld {
     template <typename Component> bool removeComponent(ecsEntity& entity) {
         return removeComponentInternal(entity, Component::Runtime_ID);
     }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Choose whether removals tombstone pooled rows instead of
+    ///         swapping the last row into their place.
+    /// \note   Tombstoned rows are destructed at once but keep their place,
+    ///         queries skip them until compactComponents reclaims them.
+    ///         Leaving tombstone mode compacts every pool.
+    /// \param	enabled				true to tombstone removals, false to swap them.
+    void setTombstoneMode(const bool enabled);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Check if removals tombstone pooled rows.
+    /// \return	true if in tombstone mode, false otherwise.
+    [[nodiscard]] bool isTombstoneMode() const noexcept { return m_tombstoneMode; }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the number of tombstoned rows awaiting compaction.
+    /// \return	the number of dead rows across every pool.
+    [[nodiscard]] size_t getTombstoneCount() const noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Reclaim tombstoned rows, a whole pool at a time.
+    /// \note   Each pool is compacted in one pass, live rows keep their order.
+    ///         Pools are visited round-robin, so budgeted calls made at idle
+    ///         times eventually reach every pool.
+    /// \param	rowBudget			the number of rows to visit before stopping,
+    ///                             at least one pool is always compacted.
+    /// \return	the number of rows reclaimed.
+    size_t compactComponents(const size_t rowBudget = std::numeric_limits<size_t>::max());
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Search for an entity and enable or disable it.
+    /// \note   Disabled entities keep their components but are skipped by all
+    ///         queries. Their rows sit at the tail of each pool, so toggling
+    ///         only swaps rows and never creates or frees components.
+    /// \param	entityHandle		handle to the entity to be modified.
+    /// \param	enabled				true to enable the entity, false to disable it.
+    /// \return	true on success, false otherwise.
+    bool setEnabled(const EntityHandle& entityHandle, const bool enabled);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Enable or disable the specified entity.
+    /// \note   Children are not affected, each entity is toggled on its own.
+    /// \param	entity      		the entity to be modified.
+    /// \param	enabled				true to enable the entity, false to disable it.
+    /// \return	true on success, false otherwise.
+    bool setEnabled(ecsEntity& entity, const bool enabled);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Check if the specified entity is enabled.
+    /// \param	entityHandle		handle to the entity to check.
+    /// \return	true if the entity exists and is enabled, false otherwise.
+    [[nodiscard]] bool isEnabled(const EntityHandle& entityHandle) const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Add a tag to the specified entity.
+    /// \tparam	Tag                 the class type of tag.
+    /// \param	entityHandle		handle to the entity to be tagged.
+    /// \return	true on success, false otherwise.
+    template <typename Tag> bool addTag(const EntityHandle& entityHandle) {
+        return setTagInternal(entityHandle, Tag::Runtime_ID, true);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Add a tag to the specified entity.
+    /// \tparam	Tag                 the class type of tag.
+    /// \param	entity      		the entity to be tagged.
+    /// \return	true on success, false otherwise.
+    template <typename Tag> bool addTag(ecsEntity& entity) { return setTagInternal(entity, Tag::Runtime_ID, true); }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Remove a tag from the specified entity.
+    /// \tparam	Tag                 the class type of tag.
+    /// \param	entityHandle		handle to the entity to be untagged.
+    /// \return	true on success, false otherwise.
+    template <typename Tag> bool removeTag(const EntityHandle& entityHandle) {
+        return setTagInternal(entityHandle, Tag::Runtime_ID, false);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Remove a tag from the specified entity.
+    /// \tparam	Tag                 the class type of tag.
+    /// \param	entity      		the entity to be untagged.
+    /// \return	true on success, false otherwise.
+    template <typename Tag> bool removeTag(ecsEntity& entity) { return setTagInternal(entity, Tag::Runtime_ID, false); }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Check if the specified entity owns a tag or component type.
+    /// \tparam	T                   the class type of tag or component.
+    /// \param	entityHandle		handle to the entity to check.
+    /// \return	true if the entity owns the type, false otherwise.
+    template <typename T>[[nodiscard]] bool hasType(const EntityHandle& entityHandle) const {
+        const auto entity = getEntity(entityHandle);
+        return entity != nullptr && entity->m_signature.test(T::Runtime_ID);
+    }
 
     ///////////////////////////////////////////////////////////////////////////
     /// \brief  Try to find an entity matching the UUID provided.
@@ -113,6 +304,26 @@ class ecsWorld {
     /// \return	list of pointers to the found entities (nullptr's omitted).
     [[nodiscard]] std::vector<std::shared_ptr<ecsEntity>> getEntities(const std::vector<EntityHandle>& uuids) const;
     ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Check where an entity's data lives, as getEntity can't find evicted entities.
+    /// \param	entityHandle		handle to the entity to check.
+    /// \return	the residency of the entity, UNKNOWN if never seen here.
+    [[nodiscard]] Residency getResidency(const EntityHandle& entityHandle) const;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Estimate how many entities match a query, from signature counts.
+    /// \note   Disabled entities are counted too, so this is an upper bound.
+    /// \param	componentTypes		the component types of the query.
+    /// \return	the number of entities whose signatures satisfy the query.
+    [[nodiscard]] size_t
+    estimateMatches(const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes) const;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the component class whose pool drives an ungrouped query.
+    /// \param	componentTypes		the component types of the query.
+    /// \param	since				ticks at or before this fail CHANGED and ADDED terms.
+    /// \return	the driving component class, or -1 if every entity's signature is scanned.
+    [[nodiscard]] ComponentID getQueryDriver(
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes,
+        const uint64_t since = 0ULL) const;
+    ///////////////////////////////////////////////////////////////////////////
     /// \brief  Search for a component type in an entity.
     /// \tparam	Component           the category of component being retrieved.
     /// \param	entityHandle	    handle to the entity to retrieve from.
@@ -142,15 +353,40 @@ class ecsWorld {
     /// \return pointer to the found component on success, nullptr on failure.
     [[nodiscard]] ecsBaseComponent* getComponent(const ComponentHandle& componentHandle);
     ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Search for a component type in an entity.
+    /// \tparam	Component           the category of component being retrieved.
+    /// \param	entityHandle	    handle to the entity to retrieve from.
+    /// \return	a component of type requested on success, nullptr otherwise.
+    template <typename Component>
+    [[nodiscard]] const Component* getComponent(const EntityHandle& entityHandle) const {
+        return dynamic_cast<const Component*>(getComponentInternal(entityHandle, Component::Runtime_ID));
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Try to retrieve a component matching the UUID provided.
+    /// \tparam	Component   		the class type of component.
+    /// \param	componentHandle		the target component's handle.
+    /// \return	the component of type T on success, nullptr otherwise.
+    template <typename Component>
+    [[nodiscard]] const Component* getComponent(const ComponentHandle& componentHandle) const {
+        return dynamic_cast<const Component*>(getComponent(componentHandle));
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Try to find a component matching the UUID provided.
+    /// \param	componentHandle		the target component's UUID.
+    /// \return pointer to the found component on success, nullptr on failure.
+    [[nodiscard]] const ecsBaseComponent* getComponent(const ComponentHandle& componentHandle) const;
+    ///////////////////////////////////////////////////////////////////////////
     /// \brief  Retrieve a list of entity components corresponding to the input.
     /// \param	componentTypes		list of component types to retrieve.
+    /// \param	since				ticks at or before this fail CHANGED and ADDED terms.
     template <typename... T_types>
-    [[nodiscard]] std::vector<std::tuple<T_types...>>
-    getComponents(const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes) {
+    [[nodiscard]] std::vector<std::tuple<T_types...>> getComponents(
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes,
+        const uint64_t since = 0ULL) {
         std::vector<std::tuple<T_types...>> entityComponents;
 
         // Cast each component set to the types requested
-        for (const auto& groupedComponents : getRelevantComponents(componentTypes)) {
+        for (const auto& groupedComponents : getRelevantComponents(componentTypes, nullptr, since)) {
             // Convert the component set to a standard array
             std::array<ecsBaseComponent*, sizeof...(T_types)> arr;
             std::copy_n(groupedComponents.cbegin(), sizeof...(T_types), arr.begin());
@@ -162,18 +398,379 @@ class ecsWorld {
         }
         return entityComponents;
     }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve a list of entity components corresponding to the input.
+    /// \tparam	T_types             const pointer types, one per component type.
+    /// \param	componentTypes		list of component types to retrieve.
+    /// \param	since				ticks at or before this fail CHANGED and ADDED terms.
+    template <typename... T_types>
+    [[nodiscard]] std::vector<std::tuple<T_types...>> getComponents(
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes,
+        const uint64_t since = 0ULL) const {
+        std::vector<std::tuple<T_types...>> entityComponents;
+
+        // Cast each component set to the types requested
+        for (const auto& groupedComponents : getRelevantComponents(componentTypes, nullptr, since)) {
+            // Convert the component set to a standard array
+            std::array<const ecsBaseComponent*, sizeof...(T_types)> arr;
+            std::copy_n(groupedComponents.cbegin(), sizeof...(T_types), arr.begin());
+
+            // Cast the array to our types and emplace it back in our vector
+            std::apply(
+                [&entityComponents](auto&... args) { entityComponents.emplace_back(dynamic_cast<T_types>(args)...); },
+                arr);
+        }
+        return entityComponents;
+    }
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve a list of entity components, in ascending order of a key.
+    /// \note   Keys may be integers, enums or floating point values. Narrow
+    ///         keys sort fastest, as byte positions all keys share are skipped.
+    /// \tparam	T_types             pointer types, one per component type.
+    /// \param	componentTypes		list of component types to retrieve.
+    /// \param	keyOf				function returning a row's key, given its components.
+    /// \param	order				optional order kept from the last call, for re-sorting.
+    template <typename... T_types, typename KeyFunction>
+    [[nodiscard]] std::vector<std::tuple<T_types...>> getSortedComponents(
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes, KeyFunction&& keyOf,
+        SortOrder* const order = nullptr) {
+        return sortRelevantComponents<T_types...>(getRelevantComponents(componentTypes), keyOf, order);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve a list of entity components, in ascending order of a key.
+    /// \tparam	T_types             const pointer types, one per component type.
+    /// \param	componentTypes		list of component types to retrieve.
+    /// \param	keyOf				function returning a row's key, given its components.
+    /// \param	order				optional order kept from the last call, for re-sorting.
+    template <typename... T_types, typename KeyFunction>
+    [[nodiscard]] std::vector<std::tuple<T_types...>> getSortedComponents(
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes, KeyFunction&& keyOf,
+        SortOrder* const order = nullptr) const {
+        return sortRelevantComponents<T_types...>(getRelevantComponents(componentTypes), keyOf, order);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Mark a component as written at the current tick, for CHANGED terms.
+    /// \note   Systems mark the types they declare written after each run.
+    /// \param	component			a component held by this world.
+    void markChanged(ecsBaseComponent& component);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Mark an entity's component as written at the current tick.
+    /// \tparam	Component           the class type of component.
+    /// \param	entityHandle		handle to the entity owning the component.
+    /// \return	true on success, false if the entity has no such component.
+    template <typename Component> bool markChanged(const EntityHandle& entityHandle) {
+        auto* component = getComponent<Component>(entityHandle);
+        if (component == nullptr) {
+            return false;
+        }
+        markChanged(*component);
+        return true;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the tick that writes are currently marked with.
+    /// \note   Advanced after each system run, so a system never sees its own writes.
+    /// \return	the current tick.
+    [[nodiscard]] uint64_t getChangeTick() const noexcept { return m_changeTick; }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the structural version of a component class.
+    /// \note   Versions change whenever a component of the class may have moved
+    ///         or been destroyed, so pointers cached under a version stay valid
+    ///         while it holds. Versions are never reused, even across worlds.
+    /// \param	componentID			the runtime component class.
+    /// \return	the class's version, zero if it has none yet.
+    [[nodiscard]] uint64_t getStructuralVersion(const ComponentID componentID) const noexcept {
+        const auto index = static_cast<size_t>(componentID);
+        return index < m_structuralVersions.size() ? m_structuralVersions[index] : 0ULL;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Generates a world singleton from the input template parameter.
+    /// \tparam	Component           the class type of singleton.
+    /// \return	the singleton, or the existing one if already made.
+    template <typename Component> Component* makeSingleton() {
+        return dynamic_cast<Component*>(makeSingletonInternal(Component::Runtime_ID, nullptr));
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Copy a component into this world as a singleton.
+    /// \param	component			the component to copy.
+    /// \return	the singleton, or the existing one if already made.
+    ecsBaseComponent* makeSingleton(const ecsBaseComponent* const component);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve a world singleton.
+    /// \tparam	Component           the class type of singleton.
+    /// \return	the singleton on success, nullptr otherwise.
+    template <typename Component>[[nodiscard]] Component* getSingleton() {
+        return dynamic_cast<Component*>(getSingletonInternal(Component::Runtime_ID));
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Remove a world singleton.
+    /// \tparam	Component           the class type of singleton.
+    /// \return	true on successful removal, false otherwise.
+    template <typename Component> bool removeSingleton() { return removeSingletonInternal(Component::Runtime_ID); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Generates a shared component value, referenced by entities.
+    /// \tparam	Component           the class type of the shared value.
+    /// \return	handle to this new shared value.
+    template <typename Component> ComponentHandle makeSharedComponent() {
+        return makeSharedComponentInternal(Component::Runtime_ID, nullptr);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Copy a component into this world as a shared value.
+    /// \param	component			the component to copy.
+    /// \return	handle to this new shared value.
+    ComponentHandle makeSharedComponent(const ecsBaseComponent* const component);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Remove a shared value, detaching it from all entities.
+    /// \param	sharedHandle		handle to the shared value.
+    /// \return	true on successful removal, false otherwise.
+    bool removeSharedComponent(const ComponentHandle& sharedHandle);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Make an entity reference a shared value, replacing any other
+    ///         shared value of the same class.
+    /// \param	entityHandle		handle to the entity to modify.
+    /// \param	sharedHandle		handle to the shared value.
+    /// \return	true on success, false otherwise.
+    bool setSharedComponent(const EntityHandle& entityHandle, const ComponentHandle& sharedHandle);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Stop an entity from referencing a shared value class.
+    /// \tparam	Component           the class type of the shared value.
+    /// \param	entityHandle		handle to the entity to modify.
+    /// \return	true on success, false otherwise.
+    template <typename Component> bool unsetSharedComponent(const EntityHandle& entityHandle) {
+        return unsetSharedComponentInternal(entityHandle, Component::Runtime_ID);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the shared value an entity references.
+    /// \tparam	Component           the class type of the shared value.
+    /// \param	entityHandle		handle to the entity to retrieve from.
+    /// \return	the shared value on success, nullptr otherwise.
+    template <typename Component>[[nodiscard]] Component* getSharedComponent(const EntityHandle& entityHandle) {
+        const auto entity = getEntity(entityHandle);
+        return entity == nullptr ? nullptr
+                                 : dynamic_cast<Component*>(getSharedComponentInternal(*entity, Component::Runtime_ID));
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve a shared value.
+    /// \tparam	Component           the class type of the shared value.
+    /// \param	sharedHandle		handle to the shared value.
+    /// \return	the shared value on success, nullptr otherwise.
+    template <typename Component>[[nodiscard]] Component* getSharedComponent(const ComponentHandle& sharedHandle) {
+        return dynamic_cast<Component*>(getSharedComponentInternal(sharedHandle));
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve a query's components, partitioned by the shared value
+    ///         of a specific class their entity references.
+    /// \note   Entities not referencing a shared value of that class are
+    ///         omitted, as are rows without any component columns.
+    /// \param	componentTypes		list of component types to retrieve.
+    /// \param	sharedID			the class of shared value to partition by.
+    /// \return	list of shared values and the rows referencing each.
+    [[nodiscard]] std::vector<std::pair<ecsBaseComponent*, std::vector<std::vector<ecsBaseComponent*>>>>
+    getSharedPartitions(
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes,
+        const ComponentID sharedID);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Move an entity, along with its children, into another world.
+    /// \param	UUID			    handle to the entity to migrate.
+    /// \param	otherWorld			the world to migrate the entity to.
     void migrateEntityTo(const EntityHandle& UUID, ecsWorld& otherWorld);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Move an entity, along with its children, into another world.
+    /// \param	entity      		the entity to migrate.
+    /// \param	otherWorld			the world to migrate the entity to.
     void migrateEntityTo(ecsEntity& entity, ecsWorld& otherWorld);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Write a set of entities out to a cold store and remove them.
+    /// \note   Only entities outside any hierarchy, whose component classes are
+    ///         all trivially copyable, can be evicted. Others are skipped.
+    /// \param	entityHandles		handles to the entities to evict.
+    /// \param	store				the store to write the entities to.
+    /// \return	the number of entities evicted.
+    size_t evictEntities(const std::vector<EntityHandle>& entityHandles, ecsColdStore& store);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Read a set of evicted entities back in from a cold store.
+    /// \note   Entities keep their handles, component handles, tags and state.
+    ///         Truncated records, or ones naming unknown types, are skipped.
+    /// \param	entityHandles		handles to the entities to restore.
+    /// \param	store				the store the entities were evicted to.
+    /// \return	the number of entities restored.
+    size_t restoreEntities(const std::vector<EntityHandle>& entityHandles, ecsColdStore& store);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Attach an entity, along with its children, to a new parent.
+    /// \param	entityHandle		handle to the child entity.
+    /// \param	parentHandle		handle to the new parent, empty to detach.
+    /// \return	true on success, false if missing or if a cycle would form.
+    bool setParent(const EntityHandle& entityHandle, const EntityHandle& parentHandle);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the parent of an entity.
+    /// \param	entityHandle		handle to the child entity.
+    /// \return	handle to the parent on success, an empty handle otherwise.
+    [[nodiscard]] EntityHandle getParent(const EntityHandle& entityHandle) const;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the children of an entity.
+    /// \param	entityHandle		handle to the parent entity.
+    /// \return	handles to the entity's children.
+    [[nodiscard]] std::vector<EntityHandle> getChildren(const EntityHandle& entityHandle) const;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Sort a component pool into breadth-first hierarchy order.
+    /// \tparam	Component           the class type of component to sort.
+    /// \return	true on success, false otherwise.
+    template <typename Component> bool sortHierarchy() { return sortHierarchy(Component::Runtime_ID); }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Sort a component pool into breadth-first hierarchy order.
+    /// \note   Afterwards every parent's component precedes its children's,
+    ///         so propagation through the pool is a single linear pass.
+    ///         Grouped and non-dense component classes cannot be sorted.
+    /// \param	componentID			the runtime component class.
+    /// \return	true on success, false otherwise.
+    bool sortHierarchy(const ComponentID componentID);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve components of a class in breadth-first hierarchy order,
+    ///         each paired with its parent entity's component of that class.
+    /// \param	componentID			the runtime component class.
+    /// \return	list of components and their parent's component (or nullptr).
+    [[nodiscard]] std::vector<std::pair<ecsBaseComponent*, ecsBaseComponent*>>
+    getHierarchyComponents(const ComponentID componentID);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Declare a group of component types whose pools are kept co-sorted.
+    /// \tparam	Components          the component types forming the group.
+    /// \return	true if the group was created, false otherwise.
+    template <typename... Components> bool makeGroup() { return makeGroup({ Components::Runtime_ID... }); }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Declare a group of component types whose pools are kept co-sorted.
+    /// \note   Entities owning every type in the group occupy the same leading
+    ///         index range of each pool, so queries requiring exactly these
+    ///         types are answered by a zipped loop over that range.
+    ///         A component type can belong to at most one group, and only
+    ///         densely stored types can be grouped.
+    /// \param	componentIDs        the component types forming the group.
+    /// \return	true if the group was created, false otherwise.
+    bool makeGroup(const std::vector<ComponentID>& componentIDs);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Register an observer to be notified of signature changes.
+    /// \param	observer			the observer to add.
+    /// \return	true if the observer was valid and added, false otherwise.
+    bool addObserver(const std::shared_ptr<ecsObserver>& observer);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Unregister an observer, discarding its pending events.
+    /// \param	observer			the observer to remove.
+    /// \return	true if successfully removed, false otherwise.
+    bool removeObserver(const ecsObserver& observer);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Deliver every observer's pending events in batches.
+    /// \note   Called automatically at the end of updateSystems.
+    void flushObservers();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Include a component class in the snapshots taken by flipBuffers.
+    /// \tparam	Component           the category of component to buffer.
+    /// \param	buffered			true to buffer the class, false to stop.
+    template <typename Component> void setDoubleBuffered(const bool buffered = true) {
+        setDoubleBuffered(Component::Runtime_ID, buffered);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Include a component class in the snapshots taken by flipBuffers.
+    /// \param	componentID			the runtime component class.
+    /// \param	buffered			true to buffer the class, false to stop.
+    /// \return	true on success, false if the class is a tag or isn't densely stored.
+    bool setDoubleBuffered(const ComponentID componentID, const bool buffered = true);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Copy the double-buffered components into the back snapshot
+    ///         and publish it as the front snapshot.
+    /// \note   Call at a frame boundary, while no system is updating. Each flip
+    ///         copies the enabled rows of every buffered pool and sorts them by
+    ///         owner, so its cost grows with the buffered row count, O(n log n).
+    void flipBuffers();
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the most recently published snapshot.
+    /// \note   The snapshot stays valid until the second following flip, so
+    ///         readers may query it for one full frame after the next flip.
+    /// \return	the front snapshot.
+    [[nodiscard]] const ecsSnapshot& getSnapshot() const noexcept { return m_snapshots[m_frontSnapshot]; }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the channel carrying events of a type, making it if needed.
+    /// \note   Making a channel is a write, while fetching a made one isn't.
+    /// \tparam	Event               the event type.
+    /// \return	the channel, valid for as long as the world lives.
+    template <typename Event> ecsEventChannel<Event>& getEventChannel() {
+        if (auto* channel = findEventChannel<Event>()) {
+            return *channel;
+        }
+
+        // Making a channel changes the map, which concurrent lookups can't see safely
+        assertWritable();
+        auto& channel = m_eventChannels[std::type_index(typeid(Event))];
+        channel = std::make_unique<ecsEventChannel<Event>>();
+        return static_cast<ecsEventChannel<Event>&>(*channel);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the channel carrying events of a type, if made.
+    /// \note   Thread-safe while no channel is being made, so systems may fetch
+    ///         channels made before they began updating.
+    /// \tparam	Event               the event type.
+    /// \return	the channel on success, nullptr otherwise.
+    template <typename Event>[[nodiscard]] ecsEventChannel<Event>* findEventChannel() const {
+        const auto channel = m_eventChannels.find(std::type_index(typeid(Event)));
+        return channel == m_eventChannels.cend() ? nullptr
+                                                 : static_cast<ecsEventChannel<Event>*>(channel->second.get());
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Flip every event channel, making this frame's events readable.
+    /// \note   Call at a frame boundary, while no system is updating.
+    void flipEvents();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Begin a span of concurrent read-only access to this world.
+    /// \note   The world must not be modified until every phase has ended.
+    /// \return	a read phase, ending when destroyed.
+    [[nodiscard]] ReadPhase beginReadPhase() const noexcept { return ReadPhase(*this); }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Check if any read phase is in progress.
+    /// \return	true if the world is being read, false otherwise.
+    [[nodiscard]] bool isReadPhase() const noexcept { return m_readers.load(std::memory_order_acquire) != 0ULL; }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Record every mutation and query made to this world from now on.
+    /// \param	recorder			the recorder to log to, nullptr to stop recording.
+    void setRecorder(ecsTraceRecorder* const recorder) noexcept { m_recorder = recorder; }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the recorder this world logs to.
+    /// \return	the recorder, nullptr if not recording.
+    [[nodiscard]] ecsTraceRecorder* getRecorder() const noexcept { return m_recorder; }
 
     ///////////////////////////////////////////////////////////////////////////
     /// \brief  Clear the data out of this ecsWorld.
     void clear();
     ///////////////////////////////////////////////////////////////////////////
     /// \brief  Generate a universally unique identifier.
+    /// \note   Thread-safe and lock-free.
     /// \return						a UUID.
     [[nodiscard]] static ecsHandle generateUUID();
     ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Reserve a block of UUID sequence numbers.
+    /// \note   Thread-safe and lock-free.
+    /// \param	count				the number of sequence numbers to reserve.
+    /// \return	the first sequence number of the block.
+    [[nodiscard]] static uint64_t reserveUUIDs(const size_t count) noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Generate the UUID of a reserved sequence number.
+    /// \param	sequence			a sequence number from reserveUUIDs.
+    /// \return						a UUID.
+    [[nodiscard]] static ecsHandle makeUUID(const uint64_t sequence) noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Move every entity staged in a spawn buffer into this world.
+    /// \note   Call at a sync point, while no worker thread uses the buffer.
+    /// \param	buffer				the buffer to splice in, left empty.
+    void spliceSpawnBuffer(ecsSpawnBuffer& buffer);
+    ///////////////////////////////////////////////////////////////////////////
     /// \brief  Update the components of all systems provided.
     /// \param	systems				the systems to update.
     /// \param	deltaTime			the delta time.
@@ -191,8 +788,143 @@ class ecsWorld {
     void updateSystem(
         const double deltaTime, const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes,
         const std::function<void(const double, const std::vector<std::vector<ecsBaseComponent*>>&)>& func);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Aggregate the components of a query across several threads.
+    /// \note   Rows are reduced in fixed-size chunks whose results combine in a
+    ///         fixed pairwise order, so the result is bit-identical for any
+    ///         number of threads. Both functions are called concurrently.
+    /// \tparam	Value               the type of the result.
+    /// \param	componentTypes		list of component types to retrieve.
+    /// \param	mapFn				function turning a row of components into a value.
+    /// \param	combineFn			associative function merging two values into one.
+    /// \param	identity			the value combining with any value leaves unchanged.
+    /// \param	threadCount			the number of threads to use, including the caller.
+    /// \return	the combination of every row's value, identity if no rows match.
+    template <typename Value, typename MapFunction, typename CombineFunction>
+    [[nodiscard]] Value reduce(
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes, MapFunction&& mapFn,
+        CombineFunction&& combineFn, const Value& identity = Value{},
+        const size_t threadCount = std::thread::hardware_concurrency()) const {
+        const auto rows = getRelevantComponents(componentTypes);
+        const auto chunkCount = (rows.size() + REDUCE_CHUNK_ROWS - 1ULL) / REDUCE_CHUNK_ROWS;
+
+        // Each chunk is reduced in row order, regardless of which thread takes it
+        std::vector<std::optional<Value>> partials(chunkCount);
+        forEachChunk(chunkCount, threadCount, [&](const size_t chunk) {
+            const auto end = std::min<size_t>(rows.size(), (chunk + 1ULL) * REDUCE_CHUNK_ROWS);
+            auto value = identity;
+            for (auto row = chunk * REDUCE_CHUNK_ROWS; row < end; ++row) {
+                value = combineFn(value, mapFn(rows[row]));
+            }
+            partials[chunk].emplace(std::move(value));
+        });
+
+        // Combine neighbours, then neighbouring pairs, and so on
+        for (size_t stride = 1; stride < chunkCount; stride *= 2ULL) {
+            for (size_t chunk = 0; chunk + stride < chunkCount; chunk += stride * 2ULL) {
+                partials[chunk].emplace(combineFn(*partials[chunk], *partials[chunk + stride]));
+            }
+        }
+        return chunkCount == 0ULL ? identity : *partials.front();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// Public Attributes
+    static constexpr size_t REDUCE_CHUNK_ROWS = 1024ULL; ///< Rows per chunk of a reduction.
 
     private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Signature masks describing a query's filter terms.
+    struct QueryMasks {
+        ecsSignature m_required; ///< Types every matching entity must own.
+        ecsSignature m_excluded; ///< Types no matching entity may own.
+        ecsSignature m_any;      ///< Types of which at least one must be owned.
+        bool m_filtered = false; ///< True if the query has tag or filter terms.
+
+        ///////////////////////////////////////////////////////////////////////////
+        /// \brief  Check if an entity signature satisfies these masks.
+        /// \param	signature       the entity signature to test.
+        /// \return	true if the signature matches, false otherwise.
+        [[nodiscard]] bool matches(const ecsSignature& signature) const noexcept {
+            return signature.containsAll(m_required) && !signature.intersects(m_excluded) &&
+                   (m_any.empty() || signature.intersects(m_any));
+        }
+    };
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  A range of driving rows for a query to visit.
+    struct QuerySlice {
+        size_t m_begin = 0ULL;       ///< The first driving row to visit.
+        size_t m_count = 0ULL;       ///< The maximum number of driving rows to visit.
+        ComponentID m_driverID = -1; ///< The driving class, updated by the query.
+        size_t m_driverSize = 0ULL;  ///< The total driving rows, updated by the query.
+        EntityHandle m_entityHandle; ///< The entity to resume from without a driving pool, updated to the next.
+    };
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  An observer and the events queued for it.
+    struct ObserverState {
+        std::shared_ptr<ecsObserver> m_observer;             ///< The observer to notify.
+        ecsSignature m_signature;                            ///< Types an entity must own.
+        std::vector<std::pair<EntityHandle, bool>> m_events; ///< Entities added (true) or removed, in order.
+    };
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  A set of component types whose pools share a leading range.
+    struct ComponentGroup {
+        std::vector<ComponentID> m_componentIDs; ///< Component types owned by this group.
+        size_t m_size = 0ULL;                    ///< Number of entities in the group.
+    };
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  How a query visits candidate rows, chosen from world statistics.
+    struct QueryPlan {
+        size_t m_driverIndex = 0ULL; ///< The driving term, or max to scan entity signatures.
+        size_t m_poolIndex = 0ULL;   ///< The term with the smallest pool, or max if none.
+        size_t m_estimate = 0ULL;    ///< Expected number of matching entities.
+    };
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Slots holding a paged or sparse component class. Slots never move,
+    ///         so removals leave holes to reuse instead of swapping rows.
+    struct ComponentStore {
+        std::vector<std::unique_ptr<uint8_t[]>> m_pages; ///< Pages of slots, released early if sparse.
+        std::vector<ComponentIndex> m_freeSlots;         ///< Released slots, reused first.
+        ComponentDataSpace m_scratch;                    ///< Space components are constructed in.
+        size_t m_pageSlots = 1ULL;                       ///< Slots per page, one if sparse.
+        size_t m_slotCount = 0ULL;                       ///< Slots handed out, released ones included.
+    };
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  The columns of a query filtered by change ticks.
+    struct ChangeFilter {
+        std::vector<std::pair<size_t, bool>> m_columns; ///< Each filtered column, true if ADDED.
+        uint64_t m_since = 0ULL;                        ///< Ticks at or before this are filtered out.
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>*
+            m_componentTypes = nullptr;                 ///< The query as written, which keys its plan.
+
+        ///////////////////////////////////////////////////////////////////////////
+        /// \brief  Check if every filtered column of a row is newer than the filter.
+        /// \param	row					the components of a query row.
+        /// \return	true if the row passes, false otherwise.
+        [[nodiscard]] bool passes(const std::vector<ecsBaseComponent*>& row) const noexcept {
+            for (const auto& [column, added] : m_columns) {
+                const auto* component = row[column];
+                if (component == nullptr || (added ? component->m_addedTick : component->m_changedTick) <= m_since) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  The liveness of a pool's rows while tombstones await compaction.
+    ///         Rows past the end of the bitmap are live.
+    struct Tombstones {
+        std::vector<bool> m_dead; ///< Whether each row is tombstoned.
+        size_t m_count = 0ULL;    ///< Rows tombstoned.
+
+        ///////////////////////////////////////////////////////////////////////////
+        /// \brief  Check if a row is tombstoned.
+        /// \param	row					the index of the row.
+        /// \return	true if dead, false if live.
+        [[nodiscard]] bool isDead(const size_t row) const noexcept { return row < m_dead.size() && m_dead[row]; }
+    };
+
     ///////////////////////////////////////////////////////////////////////////
     /// \brief  Disallow copying an ECS world.
     ecsWorld(const ecsWorld&) noexcept = delete;
@@ -201,12 +933,133 @@ class ecsWorld {
     /// \brief  Disallow ECS world copy assignment.
     ecsWorld& operator=(const ecsWorld&) noexcept = delete;
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Remove a single entity and its components, ignoring children.
+    /// \param	entity		        the entity to be removed.
+    void removeEntityInternal(ecsEntity& entity);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Unlink an entity from its parent, if it has one.
+    /// \param	entity		        the entity to detach.
+    static void detachFromParent(ecsEntity& entity);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Collect an entity and its descendants in breadth-first order.
+    /// \param	entity		        the root of the subtree.
+    /// \return	the subtree's entities, starting with the root.
+    [[nodiscard]] static std::vector<ecsEntity*> getSubtree(ecsEntity& entity);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Collect every entity in breadth-first hierarchy order.
+    /// \return	all entities, roots first and then by increasing depth.
+    [[nodiscard]] std::vector<ecsEntity*> getHierarchyOrder() const;
     ///////////////////////////////////////////////////////////////////////////
     /// \brief  Check if a component ID is valid and registered.
     /// \param	componentID			the component ID to verify.
     /// \return	true if valid and registered, false otherwise.
     [[nodiscard]] static bool isComponentIDValid(const ComponentID componentID) noexcept;
     ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Check if a component ID belongs to a zero-size tag.
+    /// \param	componentID			the component ID to verify.
+    /// \return	true if the ID is a registered tag, false otherwise.
+    [[nodiscard]] static bool isTagID(const ComponentID componentID) noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Set or clear a tag on an entity.
+    /// \param	entityHandle		handle to the entity to modify.
+    /// \param	tagID			    the runtime tag class.
+    /// \param	value			    true to set the tag, false to clear it.
+    /// \return	true on success, false otherwise.
+    bool setTagInternal(const EntityHandle& entityHandle, const ComponentID tagID, const bool value);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Set or clear a tag on an entity.
+    /// \param	entity      		the entity to modify.
+    /// \param	tagID			    the runtime tag class.
+    /// \param	value			    true to set the tag, false to clear it.
+    /// \return	true on success, false otherwise.
+    bool setTagInternal(ecsEntity& entity, const ComponentID tagID, const bool value);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Queue events for an entity which just gained a type.
+    /// \param	entity      		the entity which changed.
+    /// \param	componentID			the type which was added.
+    void recordAdded(const ecsEntity& entity, const ComponentID componentID);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Queue events for an entity which is about to lose a type.
+    /// \param	entity      		the entity which is changing.
+    /// \param	componentID			the type being removed.
+    void recordRemoved(const ecsEntity& entity, const ComponentID componentID);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Queue events for an entity which is about to be removed.
+    /// \param	entity      		the entity being removed.
+    void recordRemoved(const ecsEntity& entity);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Build the signature masks for a set of query terms.
+    /// \param	componentTypes		the component types of the query.
+    /// \return	the query's signature masks.
+    [[nodiscard]] static QueryMasks
+    makeQueryMasks(const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Count the entities whose signatures satisfy a query's masks.
+    /// \param	query				the query's signature masks.
+    /// \return	the number of matching entities.
+    [[nodiscard]] size_t countMatches(const QueryMasks& query) const;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the kept plan for a query, or plan it now without keeping it.
+    /// \note   Plans are only kept and refreshed by writers, so readers never lock.
+    /// \param	componentTypes		the component types of the query, filter terms made required.
+    /// \param	query				the query's signature masks.
+    /// \param	filter				optional ticks the rows must be newer than.
+    /// \return	the plan to execute.
+    [[nodiscard]] QueryPlan planQuery(
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes,
+        const QueryMasks& query, const ChangeFilter* const filter) const;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Plan a query from the world's current statistics.
+    /// \param	componentTypes		the component types of the query.
+    /// \param	query				the query's signature masks.
+    /// \return	the plan to execute.
+    [[nodiscard]] QueryPlan makePlan(
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes,
+        const QueryMasks& query) const;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Keep a plan for a query that is run repeatedly, such as a system's.
+    /// \param	componentTypes		the component types of the query.
+    void keepPlan(const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Re-plan every kept query once the world or a planned pool drifts twofold.
+    /// \param	componentID			the component class whose rows may have changed.
+    void refreshPlans(const ComponentID componentID);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Estimate the cost of visiting a pool's rows, each looking up its entity.
+    /// \param	rows				the number of rows visited.
+    /// \return	the estimated cost, comparable to estimateScanCost.
+    [[nodiscard]] size_t estimateDriveCost(const size_t rows) const noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Estimate the cost of testing every entity's signature.
+    /// \return	the estimated cost, comparable to estimateDriveCost.
+    [[nodiscard]] size_t estimateScanCost() const noexcept { return m_entities.size() * 2ULL; }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Count the active rows of a pool whose chunks changed after a tick.
+    /// \param	componentID			the component class/category ID.
+    /// \param	since				ticks at or before this are unchanged.
+    /// \return	the rows a filtered query driven by this pool visits.
+    [[nodiscard]] size_t countChangedRows(const ComponentID componentID, const uint64_t since) const;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Find a query's change filter terms.
+    /// \param	componentTypes		the component types of the query.
+    /// \param	since				ticks at or before this fail CHANGED and ADDED terms.
+    /// \return	the query's change filter, without columns if it has none.
+    [[nodiscard]] static ChangeFilter makeChangeFilter(
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes, const uint64_t since);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Insert a new entity, counting its signature.
+    /// \param	entity				the entity to insert.
+    /// \return	reference to the inserted entity.
+    ecsEntity& insertEntity(ecsEntity&& entity);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Set or clear a type in an entity's signature, keeping counts.
+    /// \param	entity				the entity to modify.
+    /// \param	componentID			the component or tag type.
+    /// \param	value				true to set the type, false to clear it.
+    void setSignatureBit(ecsEntity& entity, const ComponentID componentID, const bool value);
+    ///////////////////////////////////////////////////////////////////////////
     /// \brief  Adds a component to an entity.
     /// \param	entityHandle		handle to the component's parent entity.
     /// \param	componentID			the runtime component class.
@@ -221,6 +1074,15 @@ class ecsWorld {
     ComponentHandle
     makeComponentInternal(ecsEntity& entity, const ComponentID componentID, const ecsBaseComponent* const component);
     ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Adds a component to an entity under an existing handle.
+    /// \param	entity      		the entity to add a component to.
+    /// \param	componentID			the runtime component class.
+    /// \param	componentHandle		the handle for the new component.
+    /// \param  component			the component being added.
+    void insertComponent(
+        ecsEntity& entity, const ComponentID componentID, const ComponentHandle& componentHandle,
+        const ecsBaseComponent* const component);
+    ///////////////////////////////////////////////////////////////////////////
     /// \brief  Remove a specific component class from within a specific entity.
     /// \param	entityHandle		handle component's parent entity.
     /// \param	componentID			the runtime ID component class ID.
@@ -238,18 +1100,197 @@ class ecsWorld {
     /// \param	componentID			the runtime class ID of the component.
     /// \return the specific component on success, nullptr otherwise.
     [[nodiscard]] ecsBaseComponent*
-    getComponentInternal(const EntityHandle& entityHandle, const ComponentID componentID);
+    getComponentInternal(const EntityHandle& entityHandle, const ComponentID componentID) const;
     ///////////////////////////////////////////////////////////////////////////
     /// \brief  Retrieve a component.
     /// \param	ecsEntity   		the entity to get the component from.
     /// \param	componentID			the runtime class ID of the component.
     /// \return the specific component on success, nullptr otherwise.
-    [[nodiscard]] ecsBaseComponent* getComponentInternal(ecsEntity& entity, const ComponentID componentID);
+    [[nodiscard]] ecsBaseComponent* getComponentInternal(const ecsEntity& entity, const ComponentID componentID) const;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Generate a singleton of a specific class, if not yet made.
+    /// \param	componentID			the runtime component class.
+    /// \param  component			optional component to copy from.
+    /// \return	the singleton on success, nullptr otherwise.
+    ecsBaseComponent* makeSingletonInternal(const ComponentID componentID, const ecsBaseComponent* const component);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the singleton of a specific class.
+    /// \param	componentID			the runtime component class.
+    /// \return	the singleton on success, nullptr otherwise.
+    [[nodiscard]] ecsBaseComponent* getSingletonInternal(const ComponentID componentID) noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Remove the singleton of a specific class.
+    /// \param	componentID			the runtime component class.
+    /// \return	true on successful removal, false otherwise.
+    bool removeSingletonInternal(const ComponentID componentID);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Resolve the singletons a system requires for this update.
+    /// \param	system				the system to resolve singletons for.
+    /// \return	true if every singleton was found, false otherwise.
+    bool resolveSingletons(ecsSystem& system);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Generate a shared value of a specific class.
+    /// \param	componentID			the runtime component class.
+    /// \param  component			optional component to copy from.
+    /// \return	handle to this new shared value.
+    ComponentHandle makeSharedComponentInternal(const ComponentID componentID, const ecsBaseComponent* const component);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve a shared value.
+    /// \param	sharedHandle		handle to the shared value.
+    /// \return	the shared value on success, nullptr otherwise.
+    [[nodiscard]] ecsBaseComponent* getSharedComponentInternal(const ComponentHandle& sharedHandle) noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the shared value of a class an entity references.
+    /// \param	entity      		the entity to retrieve from.
+    /// \param	componentID			the runtime component class.
+    /// \return	the shared value on success, nullptr otherwise.
+    [[nodiscard]] ecsBaseComponent*
+    getSharedComponentInternal(const ecsEntity& entity, const ComponentID componentID) noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Stop an entity from referencing a shared value class.
+    /// \param	entityHandle		handle to the entity to modify.
+    /// \param	componentID			the runtime component class.
+    /// \return	true on success, false otherwise.
+    bool unsetSharedComponentInternal(const EntityHandle& entityHandle, const ComponentID componentID);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Check that no read phase is in progress, in debug builds.
+    void assertWritable() const noexcept {
+        assert(!isReadPhase() && "ecsWorld modified during a read phase");
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Find an entity without sharing ownership of it.
+    /// \param	UUID			    the target entity's UUID.
+    /// \return	pointer to the found entity on success, nullptr on failure.
+    [[nodiscard]] ecsEntity* findEntity(const EntityHandle& UUID) const noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Find the memory space of a component class, without creating it.
+    /// \param	componentID			the component class/category ID.
+    /// \return	pointer to the memory space on success, nullptr otherwise.
+    [[nodiscard]] ComponentDataSpace* findPool(const ComponentID componentID) const noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Destruct every component held in a memory space.
+    /// \param	componentID			the component class/category ID.
+    /// \param	mem_array			the memory space to free.
+    /// \param	tombstones			optional liveness of the rows, dead ones are skipped.
+    static void freeComponents(
+        const ComponentID componentID, ComponentDataSpace& mem_array, const Tombstones* const tombstones = nullptr);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Give a component class a new structural version, invalidating cached pointers.
+    /// \param	componentID			the component class/category ID.
+    void bumpStructuralVersion(const ComponentID componentID);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Give every component class a new structural version.
+    void bumpStructuralVersions();
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Generate a structural version no world has used yet.
+    /// \note   Thread-safe and lock-free.
+    /// \return	a new structural version.
+    [[nodiscard]] static uint64_t nextStructuralVersion() noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Stamp a component as added and changed at the current tick.
+    /// \param	componentID			the component class/category ID.
+    /// \param	index				the component's row if pooled, its slot otherwise.
+    void stampAdded(const ComponentID componentID, const ComponentIndex index);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Stamp a component as changed at the current tick.
+    /// \param	component			a component held by this world.
+    void stampChanged(ecsBaseComponent& component);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Raise the change summary of the chunk holding a pooled row.
+    /// \param	componentID			the component class/category ID.
+    /// \param	index				the byte offset of the row.
+    /// \param	tick				the row's change tick.
+    void raiseChunkTick(const ComponentID componentID, const size_t index, const uint64_t tick);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Find the liveness of a pool's rows, if any are tombstoned.
+    /// \param	componentID			the component class/category ID.
+    /// \return	pointer to the pool's tombstones on success, nullptr if every row is live.
+    [[nodiscard]] const Tombstones* findTombstones(const ComponentID componentID) const noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Slide a pool's live rows over its tombstones, patching owners in one pass.
+    /// \param	componentID			the component class/category ID.
+    /// \return	the number of rows reclaimed.
+    size_t compactPool(const ComponentID componentID);
     ///////////////////////////////////////////////////////////////////////////
     /// \brief  Delete a component matching an index and runtime ID.
     /// \param	componentID			the component class/category ID.
-    /// \param	index				the component index to delete.
-    void removeComponentInternal(const ComponentID componentID, const ComponentID index);
+    /// \param	index				the component's row if pooled, its slot otherwise.
+    void removeComponentInternal(const ComponentID componentID, const ComponentIndex index);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Check if a component class is kept in a dense pool.
+    /// \param	componentID			the component class/category ID.
+    /// \return	true if densely pooled, false if paged or sparse.
+    [[nodiscard]] static bool isPooled(const ComponentID componentID) noexcept {
+        return std::get<4>(ecsBaseComponent::m_componentRegistry[componentID]) == ecsStoragePolicy::DENSE;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Convert a pooled component's row into its byte offset.
+    /// \param	componentID			the component class/category ID.
+    /// \param	index				the component's row.
+    /// \return	the byte offset of the row within its pool.
+    [[nodiscard]] static size_t getByteOffset(const ComponentID componentID, const ComponentIndex index) noexcept {
+        return static_cast<size_t>(index) * std::get<2>(ecsBaseComponent::m_componentRegistry[componentID]);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Find a component from its class and the index its entity holds.
+    /// \param	componentID			the component class/category ID.
+    /// \param	index				the component's row if pooled, its slot otherwise.
+    /// \return	the component.
+    [[nodiscard]] ecsBaseComponent*
+    locateComponent(const ComponentID componentID, const ComponentIndex index) const noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Construct a component into a free slot of its class's store.
+    /// \param	componentID			the component class/category ID.
+    /// \param	componentHandle		handle to the new component.
+    /// \param	entityHandle		handle to the component's parent entity.
+    /// \param	component			optional component to copy.
+    /// \return	the slot of the new component.
+    ComponentIndex storeComponent(
+        const ComponentID componentID, const ComponentHandle& componentHandle, const EntityHandle& entityHandle,
+        const ecsBaseComponent* const component);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Destruct a stored component, leaving its slot free to reuse.
+    /// \param	componentID			the component class/category ID.
+    /// \param	slot				the slot of the component.
+    void releaseComponent(const ComponentID componentID, const ComponentIndex slot);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Swap two components of the same class, updating their owners.
+    /// \param	componentID			the component class/category ID.
+    /// \param	indexA				the first component index.
+    /// \param	indexB				the second component index.
+    void swapComponents(const ComponentID componentID, const size_t indexA, const size_t indexB);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Find the group owning the supplied component class.
+    /// \param	componentID			the component class/category ID.
+    /// \return	pointer to the owning group on success, nullptr otherwise.
+    [[nodiscard]] ComponentGroup* findGroup(const ComponentID componentID) noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Find the group owning the supplied component class.
+    /// \param	componentID			the component class/category ID.
+    /// \return	pointer to the owning group on success, nullptr otherwise.
+    [[nodiscard]] const ComponentGroup* findGroup(const ComponentID componentID) const noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Find the group whose types match a query's required types.
+    /// \param	componentTypes		the component types of the query.
+    /// \return	pointer to the matching group on success, nullptr otherwise.
+    [[nodiscard]] const ComponentGroup*
+    findGroupFor(const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes) const noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Move an entity into a group's leading range, if it qualifies.
+    /// \param	entity      		the entity to add to the group.
+    /// \param	group				the group to add the entity to.
+    void addToGroup(ecsEntity& entity, ComponentGroup& group);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Move an entity out of a group's leading range, if present.
+    /// \param	entity      		the entity to remove from the group.
+    /// \param	group				the group to remove the entity from.
+    void removeFromGroup(ecsEntity& entity, ComponentGroup& group);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Check if an entity currently occupies a group's leading range.
+    /// \param	entity      		the entity to check.
+    /// \param	group				the group to check against.
+    /// \return	true if the entity is grouped, false otherwise.
+    [[nodiscard]] static bool isInGroup(const ecsEntity& entity, const ComponentGroup& group) noexcept;
     ///////////////////////////////////////////////////////////////////////////
     /// \brief  Try to find a component matching the runtime ID provided.
     /// \param	entityComponents	the array of entity component IDS.
@@ -257,24 +1298,167 @@ class ecsWorld {
     /// \param  componentID			the class ID of the component.
     /// \return	the component pointer matching the ID specified.
     [[nodiscard]] static ecsBaseComponent* getComponentInternal(
-        const std::vector<std::tuple<ComponentID, int, ComponentHandle>>& entityComponents,
+        const std::vector<std::tuple<ComponentID, ComponentIndex, ComponentHandle>>& entityComponents,
         ComponentDataSpace& mem_array, const ComponentID componentID) noexcept;
     ///////////////////////////////////////////////////////////////////////////
     /// \brief  Retrieve the components relevant to an ECS system.
     /// \param	componentTypes		list of component types to retrieve.
-    [[nodiscard]] std::vector<std::vector<ecsBaseComponent*>>
-    getRelevantComponents(const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes);
+    /// \param	slice				optional range of driving rows to visit.
+    /// \param	since				ticks at or before this fail CHANGED and ADDED terms.
+    [[nodiscard]] std::vector<std::vector<ecsBaseComponent*>> getRelevantComponents(
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes,
+        QuerySlice* const slice = nullptr, const uint64_t since = 0ULL) const;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the components relevant to a query without change filter terms.
+    /// \param	componentTypes		list of component types to retrieve.
+    /// \param	slice				optional range of driving rows to visit.
+    /// \param	filter				optional ticks the rows must be newer than.
+    [[nodiscard]] std::vector<std::vector<ecsBaseComponent*>> queryRelevantComponents(
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes,
+        QuerySlice* const slice, const ChangeFilter* const filter) const;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the next slice of components for a time-sliced system.
+    /// \param	system				the system to retrieve components for.
+    [[nodiscard]] std::vector<std::vector<ecsBaseComponent*>> getRelevantSlice(ecsSystem& system);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Cast a query row's components to the types requested.
+    /// \tparam	T_types             pointer types, one per component type.
+    /// \param	row					the components of a query row.
+    /// \return	the row's components as a tuple.
+    template <typename... T_types, size_t... Indices>
+    [[nodiscard]] static std::tuple<T_types...>
+    castRow(const std::vector<ecsBaseComponent*>& row, std::index_sequence<Indices...> /*indices*/) {
+        return std::tuple<T_types...>(dynamic_cast<T_types>(row[Indices])...);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Order query rows by the keys of a function, casting only sorted rows.
+    /// \tparam	T_types             pointer types, one per component type.
+    /// \param	rows				the query rows to order.
+    /// \param	keyOf				function returning a row's key, given its components.
+    /// \param	order				optional order kept from the last call.
+    /// \return	the rows' components in ascending order of key.
+    template <typename... T_types, typename KeyFunction>
+    [[nodiscard]] static std::vector<std::tuple<T_types...>> sortRelevantComponents(
+        const std::vector<std::vector<ecsBaseComponent*>>& rows, KeyFunction& keyOf, SortOrder* const order) {
+        // Keys are read straight from the query's rows, only the sorted rows become tuples
+        constexpr auto indices = std::index_sequence_for<T_types...>{};
+        std::vector<uint64_t> keys;
+        keys.reserve(rows.size());
+        for (const auto& row : rows) {
+            keys.emplace_back(toSortKey(std::apply(keyOf, castRow<T_types...>(row, indices))));
+        }
+        std::vector<size_t> permutation;
+        sortRows(keys, permutation, order);
+
+        std::vector<std::tuple<T_types...>> sortedRows;
+        sortedRows.reserve(rows.size());
+        for (const auto& rowIndex : permutation) {
+            sortedRows.emplace_back(castRow<T_types...>(rows[rowIndex], indices));
+        }
+        return sortedRows;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Map a key to an unsigned integer of the same order.
+    /// \param	key					an integer, enum or floating point key.
+    /// \return	the key as an unsigned integer.
+    template <typename Key>[[nodiscard]] static uint64_t toSortKey(const Key key) noexcept {
+        if constexpr (std::is_enum_v<Key>) {
+            return toSortKey(static_cast<std::underlying_type_t<Key>>(key));
+        } else if constexpr (std::is_floating_point_v<Key>) {
+            // Negative values have every bit flipped, positive ones their sign
+            const auto value = static_cast<double>(key);
+            uint64_t bits(0ULL);
+            std::memcpy(&bits, &value, sizeof(bits));
+            return (bits >> 63U) != 0ULL ? ~bits : bits | (1ULL << 63U);
+        } else if constexpr (std::is_signed_v<Key>) {
+            return static_cast<uint64_t>(static_cast<int64_t>(key)) ^ (1ULL << 63U);
+        } else {
+            static_assert(std::is_integral_v<Key>, "Sort keys must be integers, enums or floating point values");
+            return static_cast<uint64_t>(key);
+        }
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Find the order of a set of keys, stable for equal keys.
+    /// \param	keys				the key of each row.
+    /// \param	permutation			the row at each sorted position, filled by this.
+    /// \param	order				optional order kept from the last call, updated by this.
+    static void sortRows(const std::vector<uint64_t>& keys, std::vector<size_t>& permutation, SortOrder* const order);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Sort rows with a least significant digit radix sort.
+    /// \param	keys				the key of each row.
+    /// \param	permutation			the row at each sorted position, filled by this.
+    static void radixSortRows(const std::vector<uint64_t>& keys, std::vector<size_t>& permutation);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Insertion sort rows already close to sorted, within a budget of moves.
+    /// \note   Equal keys are ordered by row, so the result matches a full sort.
+    /// \param	keys				the key of each row.
+    /// \param	permutation			a prior row order, sorted in place.
+    /// \return	true on success, false if the budget ran out leaving the order invalid.
+    [[nodiscard]] static bool resortRows(const std::vector<uint64_t>& keys, std::vector<size_t>& permutation) noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Run a function once per chunk, with chunks shared between threads.
+    /// \param	chunkCount			the number of chunks.
+    /// \param	threadCount			the number of threads to use, including the caller.
+    /// \param	work				function called with each chunk's index.
+    static void forEachChunk(
+        const size_t chunkCount, const size_t threadCount, const std::function<void(const size_t)>& work);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Count the rows of a component class owned by enabled entities.
+    /// \param	componentID			the class ID of the component.
+    /// \return	the number of rows ahead of the pool's disabled tail.
+    [[nodiscard]] size_t countActiveRows(const ComponentID componentID) const noexcept;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Move a row out of its pool's disabled tail.
+    /// \param	componentID			the class ID of the component.
+    /// \param	index				the byte offset of a row within the tail.
+    void activateRow(const ComponentID componentID, const size_t index);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Move a row into its pool's disabled tail.
+    /// \param	componentID			the class ID of the component.
+    /// \param	index				the byte offset of a row ahead of the tail.
+    void deactivateRow(const ComponentID componentID, const size_t index);
     ///////////////////////////////////////////////////////////////////////////
-    /// \brief  Find the least common component.
+    /// \brief  Find the required pooled component with the fewest enabled rows.
     /// \param	componentTypes		the component types.
-    /// \return	the byte-size of the least common component.
+    /// \return	the index of that component's term, max if there are none.
     [[nodiscard]] size_t
-    findLeastCommonComponent(const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes);
+    findLeastCommonComponent(
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>& componentTypes) const;
 
     ///////////////////////////////////////////////////////////////////////////
     /// Private Attributes
-    ComponentMap m_components = {}; ///< Map of all components in this world.
-    EntityMap m_entities = {};      ///< Map of all entities in this world.
+    ComponentMap m_components = {};                                        ///< Map of all components in this world.
+    std::map<ComponentID, ComponentStore> m_stores = {};                   ///< Paged and sparse components.
+    EntityMap m_entities = {};                                             ///< Map of all entities in this world.
+    std::vector<ComponentGroup> m_groups{};                                ///< Co-sorted component groups.
+    ComponentMap m_singletons = {};                                        ///< Map of world-level singletons.
+    std::map<ComponentHandle, ComponentDataSpace> m_sharedComponents = {}; ///< Shared component values.
+    std::vector<ObserverState> m_observers = {};                           ///< Observers and their events.
+    ecsSignature m_bufferedTypes;                                          ///< Double-buffered component classes.
+    std::array<ecsSnapshot, 2> m_snapshots;                                ///< Front and back snapshots.
+    size_t m_frontSnapshot = 0ULL;                                         ///< Index of the front snapshot.
+    size_t m_flipCount = 0ULL;                                             ///< Number of flips so far.
+    std::map<ComponentID, size_t> m_disabledCounts = {};                   ///< Disabled rows at each pool's tail.
+    std::map<ComponentID, Tombstones> m_tombstones = {};                   ///< Dead rows awaiting compaction.
+    bool m_tombstoneMode = false;                                          ///< Whether removals tombstone rows.
+    ComponentID m_compactionCursor = 0;                                    ///< The next pool to compact.
+    std::map<ComponentID, std::vector<uint64_t>> m_chunkTicks = {};        ///< Newest change per chunk of rows.
+    uint64_t m_changeTick = 1ULL;                                          ///< The tick writes are marked with.
+    std::vector<uint64_t> m_structuralVersions = {};                       ///< Structural version per class.
+    static constexpr size_t CHANGE_CHUNK_ROWS = 64ULL;                     ///< Rows per change summary.
+    std::set<EntityHandle> m_evicted = {};                                 ///< Entities held in a cold store.
+    std::map<ecsSignature, size_t> m_census = {};                          ///< Number of entities per signature.
+    std::map<std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>>, QueryPlan>
+        m_plans = {};                                                      ///< Kept plans per query.
+    std::map<ComponentID, size_t> m_plannedRows = {};                      ///< Rows per planned pool when planned.
+    size_t m_plannedEntities = 0ULL;                                       ///< Entities in the world when planned.
+    static constexpr size_t STORE_PAGE_BYTES = 16384ULL;                   ///< Bytes per page of a paged store.
+    std::map<std::type_index, std::unique_ptr<ecsBaseEventChannel>>
+        m_eventChannels = {};                                              ///< Event channels per event type.
+    ecsTraceRecorder* m_recorder = nullptr;                                ///< Recorder to log to, if any.
+    mutable std::atomic<size_t> m_readers = 0ULL;                          ///< Read phases in progress.
+    template <typename... Components> friend class ecsStaticWorld;         ///< Allows static worlds to convert.
+    friend class ecsTraceReplayer;                                         ///< Allows traces to replay by class ID.
 };
 };     // namespace mini
 #endif // MINIECS_ECSWORLD_HPP
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "ecsWorldManager.hpp"
+#include <algorithm>
+#include <set>
+#include <tuple>
+
+///////////////////////////////////////////////////////////////////////////
+/// Use our shared namespace mini
+using namespace mini;
+
+///////////////////////////////////////////////////////////////////////////
+/// ~ecsWorldManager
+///////////////////////////////////////////////////////////////////////////
+
+ecsWorldManager::~ecsWorldManager() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_tickStarted.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// ecsWorldManager
+///////////////////////////////////////////////////////////////////////////
+
+ecsWorldManager::ecsWorldManager(const size_t threadCount) {
+    // The calling thread always works, so it owns the first queue
+    const auto queueCount = std::max<size_t>(threadCount, 1ULL);
+    for (size_t i = 0; i < queueCount; ++i) {
+        m_queues.emplace_back(std::make_unique<WorkQueue>());
+    }
+    for (size_t i = 1; i < queueCount; ++i) {
+        m_threads.emplace_back(&ecsWorldManager::runWorker, this, i);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// addWorld
+///////////////////////////////////////////////////////////////////////////
+
+size_t ecsWorldManager::addWorld(ecsWorld&& world) {
+    const auto worldIndex = m_worlds.size();
+    m_worlds.emplace_back(std::make_unique<WorldSlot>());
+    m_worlds.back()->m_world = std::move(world);
+
+    // Spread worlds evenly, each keeps its thread between ticks
+    m_queues[worldIndex % m_queues.size()]->m_worlds.emplace_back(worldIndex);
+    return worldIndex;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// postMessage
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorldManager::postMessage(const size_t worldIndex, Message message) {
+    m_worlds[worldIndex]->m_messages.push(std::move(message));
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// requestMigration
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorldManager::requestMigration(
+    const size_t fromWorld, const EntityHandle& entityHandle, const size_t toWorld) {
+    m_migrations.push(Migration{ fromWorld, entityHandle, toWorld });
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// updateWorlds
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorldManager::updateWorlds(const double deltaTime) {
+    // Only messages sent before this tick are delivered during it
+    for (auto& slot : m_worlds) {
+        while (auto message = slot->m_messages.pop()) {
+            slot->m_inbox.emplace_back(std::move(*message));
+        }
+    }
+    for (auto& queue : m_queues) {
+        queue->m_next.store(0ULL, std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_deltaTime = deltaTime;
+        m_busyWorkers = m_threads.size();
+        ++m_tick;
+    }
+    m_tickStarted.notify_all();
+
+    // Help out, then wait for the workers to finish
+    drainQueues(0ULL);
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_tickFinished.wait(lock, [&] { return m_busyWorkers == 0ULL; });
+    }
+    applyMigrations();
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// runWorker
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorldManager::runWorker(const size_t queueIndex) {
+    size_t tick = 0ULL;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_tickStarted.wait(lock, [&] { return m_stopping || m_tick != tick; });
+            if (m_stopping) {
+                return;
+            }
+            tick = m_tick;
+        }
+
+        drainQueues(queueIndex);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_busyWorkers == 0ULL) {
+                m_tickFinished.notify_one();
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// drainQueues
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorldManager::drainQueues(const size_t queueIndex) {
+    // Worlds are claimed atomically, first from our own queue, then stolen
+    const auto queueCount = m_queues.size();
+    for (size_t i = 0; i < queueCount; ++i) {
+        auto& queue = *m_queues[(queueIndex + i) % queueCount];
+        const auto worldCount = queue.m_worlds.size();
+        for (auto index = queue.m_next.fetch_add(1ULL, std::memory_order_relaxed); index < worldCount;
+             index = queue.m_next.fetch_add(1ULL, std::memory_order_relaxed)) {
+            updateWorld(queue.m_worlds[index]);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// updateWorld
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorldManager::updateWorld(const size_t worldIndex) {
+    auto& slot = *m_worlds[worldIndex];
+    for (const auto& message : slot.m_inbox) {
+        message(slot.m_world);
+    }
+    slot.m_inbox.clear();
+    slot.m_world.updateSystems(slot.m_systems, m_deltaTime);
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// applyMigrations
+///////////////////////////////////////////////////////////////////////////
+
+void ecsWorldManager::applyMigrations() {
+    std::vector<Migration> migrations;
+    while (auto migration = m_migrations.pop()) {
+        migrations.emplace_back(std::move(*migration));
+    }
+
+    // Group migrations between the same pair of worlds, keeping their order. An entity moving
+    // again starts a new batch, so chained moves still apply in request order.
+    const auto byWorldPair = [](const Migration& a, const Migration& b) {
+        return std::tie(a.m_fromWorld, a.m_toWorld) < std::tie(b.m_fromWorld, b.m_toWorld);
+    };
+    std::set<EntityHandle> batched;
+    auto batchBegin = migrations.begin();
+    for (auto migration = migrations.begin(); migration != migrations.end(); ++migration) {
+        if (!batched.insert(migration->m_entityHandle).second) {
+            std::stable_sort(batchBegin, migration, byWorldPair);
+            batched = { migration->m_entityHandle };
+            batchBegin = migration;
+        }
+    }
+    std::stable_sort(batchBegin, migrations.end(), byWorldPair);
+    for (const auto& migration : migrations) {
+        if (migration.m_fromWorld != migration.m_toWorld) {
+            m_worlds[migration.m_fromWorld]->m_world.migrateEntityTo(
+                migration.m_entityHandle, m_worlds[migration.m_toWorld]->m_world);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+#pragma once
+#ifndef MINIECS_ECSWORLDMANAGER_HPP
+#define MINIECS_ECSWORLDMANAGER_HPP
+
+#include "ecsMessageQueue.hpp"
+#include "ecsSystem.hpp"
+#include "ecsWorld.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mini {
+///////////////////////////////////////////////////////////////////////////
+/// \class  ecsWorldManager
+/// \brief  Owns many independent ecsWorlds, updating them in parallel.
+/// \note   Each world is preferably updated by the same thread every tick,
+///         idle threads steal worlds from busy ones. Worlds interact only
+///         through messages and migrations, which are thread-safe to send.
+class ecsWorldManager final {
+    public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Message type, run on its receiving world before its update.
+    using Message = std::function<void(ecsWorld&)>;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Stop all worker threads and destroy every world.
+    ~ecsWorldManager();
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Construct a manager with a set number of threads.
+    /// \param	threadCount			the number of threads, including the caller.
+    explicit ecsWorldManager(const size_t threadCount = std::thread::hardware_concurrency());
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Take ownership of a world.
+    /// \note   Not thread-safe, call between updates.
+    /// \param	world				the world to take ownership of.
+    /// \return	the index of the world.
+    size_t addWorld(ecsWorld&& world = ecsWorld());
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve a world.
+    /// \param	worldIndex			the index of the world.
+    /// \return	the world at the index specified.
+    [[nodiscard]] ecsWorld& getWorld(const size_t worldIndex) noexcept { return m_worlds[worldIndex]->m_world; }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the systems updating a world.
+    /// \param	worldIndex			the index of the world.
+    /// \return	the systems of the world at the index specified.
+    [[nodiscard]] ecsSystemList& getSystems(const size_t worldIndex) noexcept {
+        return m_worlds[worldIndex]->m_systems;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the number of worlds owned.
+    /// \return	the number of worlds.
+    [[nodiscard]] size_t getWorldCount() const noexcept { return m_worlds.size(); }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Retrieve the number of threads updating worlds.
+    /// \return	the number of threads, including the caller.
+    [[nodiscard]] size_t getThreadCount() const noexcept { return m_queues.size(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Send a message to a world.
+    /// \note   Thread-safe and lock-free, may be called from inside systems.
+    ///         Messages sent during a tick are delivered in the next tick.
+    /// \param	worldIndex			the index of the receiving world.
+    /// \param	message				the message to run on the receiving world.
+    void postMessage(const size_t worldIndex, Message message);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Request an entity to migrate between worlds.
+    /// \note   Thread-safe and lock-free, may be called from inside systems.
+    ///         Migrations are batched and applied at the end of each tick.
+    /// \param	fromWorld			the index of the world owning the entity.
+    /// \param	entityHandle		handle to the entity to migrate.
+    /// \param	toWorld				the index of the world to migrate into.
+    void requestMigration(const size_t fromWorld, const EntityHandle& entityHandle, const size_t toWorld);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Update every world once, returning when all have finished.
+    /// \note   The calling thread helps update worlds.
+    /// \param	deltaTime			the delta time.
+    void updateWorlds(const double deltaTime);
+
+    private:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Disallow copying a world manager.
+    ecsWorldManager(const ecsWorldManager&) = delete;
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Disallow world manager copy assignment.
+    ecsWorldManager& operator=(const ecsWorldManager&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  A world, its systems and its incoming messages.
+    struct WorldSlot {
+        ecsWorld m_world;                    ///< The world.
+        ecsSystemList m_systems;             ///< Systems updating the world.
+        ecsMessageQueue<Message> m_messages; ///< Messages awaiting the next tick.
+        std::vector<Message> m_inbox;        ///< Messages delivered this tick.
+    };
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  The worlds a thread prefers to update, claimed atomically.
+    struct WorkQueue {
+        std::vector<size_t> m_worlds;      ///< Indices of the worlds with affinity.
+        std::atomic<size_t> m_next = 0ULL; ///< Next unclaimed world this tick.
+    };
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  An entity waiting to migrate between worlds.
+    struct Migration {
+        size_t m_fromWorld = 0ULL;   ///< The index of the world owning the entity.
+        EntityHandle m_entityHandle; ///< Handle to the entity to migrate.
+        size_t m_toWorld = 0ULL;     ///< The index of the world to migrate into.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Wait for and run ticks on a worker thread.
+    /// \param	queueIndex			the index of the thread's work queue.
+    void runWorker(const size_t queueIndex);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Update worlds until every work queue is empty.
+    /// \param	queueIndex			the index of the thread's own work queue.
+    void drainQueues(const size_t queueIndex);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Deliver a world's messages, then update its systems.
+    /// \param	worldIndex			the index of the world.
+    void updateWorld(const size_t worldIndex);
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Apply every requested migration, batched by world pair.
+    /// \note   Batches end where an entity migrates again, keeping its moves in order.
+    void applyMigrations();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// Private Attributes
+    std::vector<std::unique_ptr<WorldSlot>> m_worlds; ///< Owned worlds.
+    std::vector<std::unique_ptr<WorkQueue>> m_queues; ///< Work queues, one per thread.
+    std::vector<std::thread> m_threads;               ///< Worker threads, the caller excluded.
+    ecsMessageQueue<Migration> m_migrations;          ///< Migrations awaiting the tick's end.
+    std::mutex m_mutex;                               ///< Guards tick start and completion.
+    std::condition_variable m_tickStarted;            ///< Wakes workers for a new tick.
+    std::condition_variable m_tickFinished;           ///< Wakes the caller once workers finish.
+    size_t m_tick = 0ULL;                             ///< Number of ticks started.
+    size_t m_busyWorkers = 0ULL;                      ///< Workers yet to finish this tick.
+    double m_deltaTime = 0.0;                         ///< Delta time of this tick.
+    bool m_stopping = false;                          ///< True once workers should exit.
+};
+};     // namespace mini
+#endif // MINIECS_ECSWORLDMANAGER_HPP
\ No newline at end of file
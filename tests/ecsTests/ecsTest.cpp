@@ -1,7 +1,19 @@
+#include "ecsComponentRef.hpp"
+#include "ecsStaticWorld.hpp"
 #include "ecsWorld.hpp"
+#include "ecsWorldManager.hpp"
+#ifdef MINIECS_COROUTINES
+#include "ecsAsyncSystem.hpp"
+#include <algorithm>
+#include <future>
+#endif
 #include <cassert>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <limits>
 #include <string>
+#include <thread>
 
 using namespace mini;
 
@@ -13,6 +25,44 @@ struct BarComponent : ecsComponent<BarComponent> {
     bool asd = false;
 };
 
+struct ConfigComponent : ecsComponent<ConfigComponent> {
+    double gravity = -9.81;
+};
+
+struct PointComponent : ecsComponent<PointComponent> {
+    float x = 0.0F;
+    float y = 0.0F;
+};
+namespace mini {
+template <> struct ecsComponentTraits<PointComponent> : ecsTrivialComponentTraits {};
+} // namespace mini
+
+struct ScriptComponent : ecsComponent<ScriptComponent> {
+    std::vector<int> lines;
+};
+
+struct DebugComponent : ecsComponent<DebugComponent> {
+    float samples[64] = {};
+};
+namespace mini {
+template <> struct ecsComponentTraits<ScriptComponent> {
+    static constexpr bool TriviallyCopyable = false;
+    static constexpr bool TriviallyDestructible = false;
+    static constexpr ecsStoragePolicy Storage = ecsStoragePolicy::SPARSE;
+};
+template <> struct ecsComponentTraits<DebugComponent> : ecsTrivialComponentTraits {
+    static constexpr ecsStoragePolicy Storage = ecsStoragePolicy::PAGED;
+};
+} // namespace mini
+
+struct NameComponent : ecsComponent<NameComponent> {
+    std::vector<char> name;
+};
+
+struct FrozenTag : ecsTag<FrozenTag> {};
+
+struct EnemyTag : ecsTag<EnemyTag> {};
+
 class FooSystem : public ecsSystem {
     public:
     FooSystem() noexcept { addComponentType(FooComponent::Runtime_ID, RequirementsFlag::REQUIRED); }
@@ -23,6 +73,135 @@ class FooSystem : public ecsSystem {
     }
 };
 
+class ConfigSystem : public ecsSystem {
+    public:
+    ConfigSystem() {
+        addComponentType(FooComponent::Runtime_ID, RequirementsFlag::REQUIRED);
+        addSingletonType(ConfigComponent::Runtime_ID);
+    }
+
+    void updateComponents(
+        const double /*deltaTime*/, const std::vector<std::vector<ecsBaseComponent*>>& components) override {
+        m_gravity = getSingleton<ConfigComponent>()->gravity;
+        m_rows = components.size();
+    }
+
+    double m_gravity = 0.0;
+    size_t m_rows = 0ULL;
+};
+
+class CountingSystem : public ecsSystem {
+    public:
+    CountingSystem() { addComponentType(FooComponent::Runtime_ID, RequirementsFlag::REQUIRED); }
+
+    void updateComponents(
+        const double deltaTime, const std::vector<std::vector<ecsBaseComponent*>>& components) override {
+        ++m_runs;
+        m_rows += components.size();
+        m_time += deltaTime;
+    }
+
+    size_t m_runs = 0ULL;
+    size_t m_rows = 0ULL;
+    double m_time = 0.0;
+};
+
+class PointFilterSystem : public ecsSystem {
+    public:
+    explicit PointFilterSystem(const RequirementsFlag pointFlag) {
+        addComponentType(PointComponent::Runtime_ID, pointFlag);
+    }
+
+    void updateComponents(
+        const double /*deltaTime*/, const std::vector<std::vector<ecsBaseComponent*>>& components) override {
+        m_rows = components.size();
+    }
+
+    size_t m_rows = 0ULL;
+};
+
+class EnemyScanSystem : public ecsSystem {
+    public:
+    EnemyScanSystem() {
+        addComponentType(EnemyTag::Runtime_ID, RequirementsFlag::REQUIRED);
+        addComponentType(FooComponent::Runtime_ID, RequirementsFlag::OPTIONAL);
+    }
+
+    void updateComponents(
+        const double /*deltaTime*/, const std::vector<std::vector<ecsBaseComponent*>>& components) override {
+        m_visited.clear();
+        for (const auto& row : components) {
+            auto* foo = static_cast<FooComponent*>(row[1]);
+            foo->qwe = false;
+            m_visited.emplace_back(foo->m_entityHandle);
+        }
+    }
+
+    std::vector<EntityHandle> m_visited;
+};
+
+class DriftSystem : public ecsSystem {
+    public:
+    DriftSystem() { addComponentType(PointComponent::Runtime_ID, RequirementsFlag::REQUIRED, true); }
+
+    void updateComponents(
+        const double deltaTime, const std::vector<std::vector<ecsBaseComponent*>>& components) override {
+        for (const auto& row : components) {
+            static_cast<PointComponent*>(row[0])->x += static_cast<float>(deltaTime);
+        }
+    }
+};
+
+class PointFooSystem : public ecsSystem {
+    public:
+    PointFooSystem() {
+        addComponentType(PointComponent::Runtime_ID, RequirementsFlag::REQUIRED);
+        addComponentType(FooComponent::Runtime_ID, RequirementsFlag::REQUIRED);
+    }
+
+    void updateComponents(
+        const double /*deltaTime*/, const std::vector<std::vector<ecsBaseComponent*>>& components) override {
+        m_rows = components.size();
+    }
+
+    size_t m_rows = 0ULL;
+};
+
+#ifdef MINIECS_COROUTINES
+class PathSystem : public ecsAsyncSystem {
+    public:
+    ecsAsyncTask run(ecsAsyncContext& context) override {
+        ++m_starts;
+        const auto length = co_await m_job;
+        context.defer([length](ecsWorld& world) {
+            PointComponent point;
+            point.x = static_cast<float>(length);
+            [[maybe_unused]] const auto pointHandle = world.makeComponent(world.makeEntity(), &point);
+        });
+        co_await context.nextTick();
+        ++m_finishes;
+    }
+
+    std::future<int> m_job;
+    size_t m_starts = 0ULL;
+    size_t m_finishes = 0ULL;
+};
+#endif
+
+class FooBarObserver : public ecsObserver {
+    public:
+    FooBarObserver() {
+        addComponentType(FooComponent::Runtime_ID);
+        addComponentType(BarComponent::Runtime_ID);
+    }
+
+    void onEntitiesAdded(const std::vector<EntityHandle>& entities) override { m_added += entities.size(); }
+    void onEntitiesRemoved(const std::vector<EntityHandle>& entities) override { m_removed += entities.size(); }
+
+    size_t m_added = 0ULL;
+    size_t m_removed = 0ULL;
+};
+
 int main() noexcept {
     ecsWorld world = ecsWorld();
 
@@ -43,5 +222,1300 @@ int main() noexcept {
     constexpr auto timeStep = 0.01;
     FooSystem system;
     world.updateSystem(system, timeStep);
+
+    // Grouped pools keep matching entities zipped at the front
+    {
+        ecsWorld groupWorld;
+        const auto first = groupWorld.makeEntity();
+        const auto second = groupWorld.makeEntity();
+        const auto third = groupWorld.makeEntity();
+        [[maybe_unused]] const auto firstFoo = groupWorld.makeComponent<FooComponent>(first);
+        [[maybe_unused]] const auto secondFoo = groupWorld.makeComponent<FooComponent>(second);
+        [[maybe_unused]] const auto secondBar = groupWorld.makeComponent<BarComponent>(second);
+        [[maybe_unused]] const auto grouped = groupWorld.makeGroup<FooComponent, BarComponent>();
+        assert(grouped);
+        assert((!groupWorld.makeGroup<FooComponent, BarComponent>()));
+        [[maybe_unused]] const auto thirdBar = groupWorld.makeComponent<BarComponent>(third);
+        [[maybe_unused]] const auto thirdFoo = groupWorld.makeComponent<FooComponent>(third);
+        [[maybe_unused]] const auto firstBar = groupWorld.makeComponent<BarComponent>(first);
+
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>> groupIDs = {
+            { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED },
+            { BarComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED }
+        };
+        [[maybe_unused]] auto rows = groupWorld.getComponents<FooComponent*, BarComponent*>(groupIDs);
+        assert(rows.size() == 3);
+        for ([[maybe_unused]] const auto& [foo, bar] : rows) {
+            assert(foo->m_entityHandle == bar->m_entityHandle);
+        }
+
+        [[maybe_unused]] const auto removed = groupWorld.removeComponent<BarComponent>(second);
+        assert(removed);
+        rows = groupWorld.getComponents<FooComponent*, BarComponent*>(groupIDs);
+        assert(rows.size() == 2);
+        for ([[maybe_unused]] const auto& [foo, bar] : rows) {
+            assert(foo->m_entityHandle == bar->m_entityHandle);
+            assert(!(foo->m_entityHandle == second));
+        }
+
+        groupWorld.removeEntity(third);
+        rows = groupWorld.getComponents<FooComponent*, BarComponent*>(groupIDs);
+        assert(rows.size() == 1);
+        assert(std::get<0>(rows[0])->m_entityHandle == first);
+        assert(std::get<1>(rows[0])->m_entityHandle == first);
+    }
+
+    // Tags live only in signatures and filter queries without storage
+    {
+        ecsWorld tagWorld;
+        const auto frozen = tagWorld.makeEntity();
+        const auto enemy = tagWorld.makeEntity();
+        const auto plain = tagWorld.makeEntity();
+        for (const auto& entity : { frozen, enemy, plain }) {
+            [[maybe_unused]] const auto fooHandle = tagWorld.makeComponent<FooComponent>(entity);
+        }
+        [[maybe_unused]] const auto tagged = tagWorld.addTag<FrozenTag>(frozen);
+        assert(tagged);
+        tagWorld.addTag<EnemyTag>(enemy);
+        assert(tagWorld.hasType<FrozenTag>(frozen));
+        assert(!tagWorld.hasType<FrozenTag>(enemy));
+        assert(!tagWorld.makeComponent<FrozenTag>(plain).isValid());
+
+        [[maybe_unused]] const auto awake = tagWorld.getComponents<FooComponent*, ecsBaseComponent*>(
+            { { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED },
+              { FrozenTag::Runtime_ID, ecsSystem::RequirementsFlag::EXCLUDE } });
+        assert(awake.size() == 2);
+        [[maybe_unused]] const auto marked =
+            tagWorld.getComponents<FooComponent*, ecsBaseComponent*, ecsBaseComponent*>(
+                { { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED },
+                  { FrozenTag::Runtime_ID, ecsSystem::RequirementsFlag::ANY },
+                  { EnemyTag::Runtime_ID, ecsSystem::RequirementsFlag::ANY } });
+        assert(marked.size() == 2);
+        [[maybe_unused]] const auto enemies = tagWorld.getComponents<ecsBaseComponent*>(
+            { { EnemyTag::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED } });
+        assert(enemies.size() == 1);
+        assert(std::get<0>(enemies[0]) == nullptr);
+
+        tagWorld.removeTag<FrozenTag>(frozen);
+        assert(!tagWorld.hasType<FrozenTag>(frozen));
+    }
+
+    // Singletons are resolved once per update, shared values partition rows
+    {
+        ecsWorld resourceWorld;
+        const auto first = resourceWorld.makeEntity();
+        const auto second = resourceWorld.makeEntity();
+        const auto third = resourceWorld.makeEntity();
+        for (const auto& entity : { first, second, third }) {
+            [[maybe_unused]] const auto fooHandle = resourceWorld.makeComponent<FooComponent>(entity);
+        }
+
+        ConfigSystem configSystem;
+        resourceWorld.updateSystem(configSystem, timeStep);
+        assert(configSystem.m_rows == 0ULL);
+        resourceWorld.makeSingleton<ConfigComponent>()->gravity = 1.0;
+        resourceWorld.updateSystem(configSystem, timeStep);
+        assert(configSystem.m_rows == 3ULL);
+        assert(configSystem.m_gravity == 1.0);
+
+        const auto sharedA = resourceWorld.makeSharedComponent<BarComponent>();
+        const auto sharedB = resourceWorld.makeSharedComponent<BarComponent>();
+        resourceWorld.setSharedComponent(first, sharedA);
+        resourceWorld.setSharedComponent(second, sharedB);
+        resourceWorld.setSharedComponent(third, sharedA);
+        assert(
+            resourceWorld.getSharedComponent<BarComponent>(first) ==
+            resourceWorld.getSharedComponent<BarComponent>(sharedA));
+
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>> fooIDs = {
+            { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED }
+        };
+        [[maybe_unused]] auto partitions = resourceWorld.getSharedPartitions(fooIDs, BarComponent::Runtime_ID);
+        assert(partitions.size() == 2);
+        assert(partitions[0].second.size() + partitions[1].second.size() == 3);
+
+        resourceWorld.removeSharedComponent(sharedA);
+        partitions = resourceWorld.getSharedPartitions(fooIDs, BarComponent::Runtime_ID);
+        assert(partitions.size() == 1);
+        assert(partitions[0].second.size() == 1);
+        assert(resourceWorld.getSharedComponent<BarComponent>(first) == nullptr);
+        [[maybe_unused]] const auto removedConfig = resourceWorld.removeSingleton<ConfigComponent>();
+        assert(removedConfig);
+    }
+
+    // Hierarchies link parents and children, and sort pools by depth
+    {
+        ecsWorld sceneWorld;
+        ecsWorld otherWorld;
+        const auto grandchild = sceneWorld.makeEntity();
+        const auto child = sceneWorld.makeEntity();
+        const auto root = sceneWorld.makeEntity();
+        for (const auto& entity : { grandchild, child, root }) {
+            [[maybe_unused]] const auto fooHandle = sceneWorld.makeComponent<FooComponent>(entity);
+        }
+        sceneWorld.setParent(child, root);
+        sceneWorld.setParent(grandchild, child);
+        assert(!sceneWorld.setParent(root, grandchild));
+        assert(sceneWorld.getParent(grandchild) == child);
+        assert(sceneWorld.getChildren(root).size() == 1);
+
+        [[maybe_unused]] const auto sorted = sceneWorld.sortHierarchy<FooComponent>();
+        assert(sorted);
+        [[maybe_unused]] const auto rows = sceneWorld.getComponents<FooComponent*>(
+            { { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED } });
+        assert(std::get<0>(rows[0])->m_entityHandle == root);
+        assert(std::get<0>(rows[1])->m_entityHandle == child);
+        assert(std::get<0>(rows[2])->m_entityHandle == grandchild);
+        [[maybe_unused]] const auto pairs = sceneWorld.getHierarchyComponents(FooComponent::Runtime_ID);
+        assert(pairs.size() == 3);
+        assert(pairs[0].second == nullptr);
+        assert(pairs[2].second == pairs[1].first);
+
+        sceneWorld.migrateEntityTo(child, otherWorld);
+        assert(sceneWorld.getChildren(root).empty());
+        assert(otherWorld.getParent(grandchild) == child);
+        otherWorld.removeEntity(child);
+        assert(otherWorld.getEntity(grandchild) == nullptr);
+    }
+
+    // Observers receive batched signature changes at flush points
+    {
+        ecsWorld observedWorld;
+        const auto observer = std::make_shared<FooBarObserver>();
+        observedWorld.addObserver(observer);
+        const auto first = observedWorld.makeEntity();
+        const auto second = observedWorld.makeEntity();
+        const auto transient = observedWorld.makeEntity();
+        for (const auto& entity : { first, second, transient }) {
+            [[maybe_unused]] const auto fooHandle = observedWorld.makeComponent<FooComponent>(entity);
+            [[maybe_unused]] const auto barHandle = observedWorld.makeComponent<BarComponent>(entity);
+        }
+        observedWorld.removeEntity(transient);
+        observedWorld.flushObservers();
+        assert(observer->m_added == 2ULL);
+        assert(observer->m_removed == 0ULL);
+
+        observedWorld.removeComponent<BarComponent>(first);
+        observedWorld.removeComponent<FooComponent>(first);
+        observedWorld.flushObservers();
+        assert(observer->m_removed == 1ULL);
+        observedWorld.clear();
+        observedWorld.flushObservers();
+        assert(observer->m_removed == 2ULL);
+    }
+
+    // Systems can run at their own rate, and over slices of their query
+    {
+        ecsWorld rateWorld;
+        for (auto i = 0; i < 5; ++i) {
+            [[maybe_unused]] const auto fooHandle = rateWorld.makeComponent<FooComponent>(rateWorld.makeEntity());
+        }
+
+        CountingSystem intervalSystem;
+        intervalSystem.setUpdateInterval(2ULL);
+        for (auto i = 0; i < 4; ++i) {
+            rateWorld.updateSystem(intervalSystem, 1.0);
+        }
+        assert(intervalSystem.m_runs == 2ULL);
+        assert(intervalSystem.m_time == 4.0);
+
+        CountingSystem fixedSystem;
+        fixedSystem.setFixedTimestep(0.5);
+        rateWorld.updateSystem(fixedSystem, 1.25);
+        assert(fixedSystem.m_runs == 2ULL);
+        rateWorld.updateSystem(fixedSystem, 0.25);
+        assert(fixedSystem.m_runs == 3ULL);
+
+        // One long update runs no more than the capped steps, dropping the rest
+        CountingSystem cappedSystem;
+        cappedSystem.setFixedTimestep(0.5, 4ULL);
+        rateWorld.updateSystem(cappedSystem, 100.25);
+        assert(cappedSystem.m_runs == 4ULL);
+        rateWorld.updateSystem(cappedSystem, 0.25);
+        assert(cappedSystem.m_runs == 5ULL);
+
+        CountingSystem slicedSystem;
+        slicedSystem.setTimeSlice(2ULL);
+        rateWorld.updateSystem(slicedSystem, timeStep);
+        assert(slicedSystem.m_rows == 2ULL);
+        rateWorld.removeEntity(
+            std::get<0>(rateWorld.getComponents<FooComponent*>(
+                            { { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED } })[0])
+                ->m_entityHandle);
+        rateWorld.updateSystem(slicedSystem, timeStep);
+        assert(slicedSystem.m_rows == 4ULL);
+        rateWorld.updateSystem(slicedSystem, timeStep);
+        assert(slicedSystem.m_rows == 6ULL);
+        assert(slicedSystem.m_runs == 3ULL);
+
+        // Signature scans resume from the next entity, removals ahead of it skip nobody
+        ecsWorld scanWorld;
+        for (int i = 0; i < 12; ++i) {
+            const auto entity = scanWorld.makeEntity();
+            scanWorld.addTag<EnemyTag>(entity);
+            [[maybe_unused]] const auto fooHandle = scanWorld.makeComponent<FooComponent>(entity);
+        }
+        EnemyScanSystem scanSystem;
+        scanSystem.setTimeSlice(4ULL);
+        scanWorld.updateSystem(scanSystem, timeStep);
+        std::vector<EntityHandle> scanned;
+        for (const auto& [foo] : scanWorld.getComponents<FooComponent*>(
+                 { { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED } })) {
+            if (!foo->qwe) {
+                scanned.emplace_back(foo->m_entityHandle);
+            }
+        }
+        assert(scanned.size() == 4ULL);
+        for (const auto& entity : scanned) {
+            scanWorld.removeEntity(entity);
+        }
+        scanWorld.updateSystem(scanSystem, timeStep);
+        assert(scanSystem.m_visited.size() == 4ULL);
+        for (const auto& [foo] : scanWorld.getComponents<FooComponent*>(
+                 { { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED } })) {
+            for (const auto& visited : scanSystem.m_visited) {
+                assert(!foo->qwe || visited < foo->m_entityHandle);
+            }
+        }
+        scanWorld.updateSystem(scanSystem, timeStep);
+        for (const auto& [foo] : scanWorld.getComponents<FooComponent*>(
+                 { { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED } })) {
+            assert(!foo->qwe);
+        }
+    }
+    // Snapshots hold a frame's buffered components while the world moves on
+    {
+        ecsWorld bufferedWorld;
+        bufferedWorld.setDoubleBuffered<FooComponent>();
+        assert(!bufferedWorld.setDoubleBuffered(FrozenTag::Runtime_ID));
+        const auto entity = bufferedWorld.makeEntity();
+        [[maybe_unused]] const auto fooHandle = bufferedWorld.makeComponent<FooComponent>(entity);
+        [[maybe_unused]] const auto barHandle = bufferedWorld.makeComponent<BarComponent>(entity);
+        bufferedWorld.flipBuffers();
+
+        const auto& snapshot = bufferedWorld.getSnapshot();
+        bufferedWorld.getComponent<FooComponent>(entity)->qwe = false;
+        assert(snapshot.getFrame() == 1ULL);
+        assert(snapshot.getComponent<FooComponent>(entity)->qwe);
+        assert(snapshot.getComponent<BarComponent>(entity) == nullptr);
+        [[maybe_unused]] const auto fooRows = snapshot.getComponents<const FooComponent*>(
+            { { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED } });
+        [[maybe_unused]] const auto fooBarRows = snapshot.getComponents<const FooComponent*, const BarComponent*>(
+            { { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED },
+              { BarComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED } });
+        assert(fooRows.size() == 1ULL);
+        assert(fooBarRows.empty());
+
+        // The previous snapshot survives one more flip
+        bufferedWorld.flipBuffers();
+        assert(snapshot.getComponent<FooComponent>(entity)->qwe);
+        assert(!bufferedWorld.getSnapshot().getComponent<FooComponent>(entity)->qwe);
+        assert(bufferedWorld.getSnapshot().getFrame() == 2ULL);
+
+        // Records gather every buffered class of an entity, disabled entities are left out
+        bufferedWorld.setDoubleBuffered<BarComponent>();
+        const auto hidden = bufferedWorld.makeEntity();
+        [[maybe_unused]] const auto hiddenHandle = bufferedWorld.makeComponent<FooComponent>(hidden);
+        [[maybe_unused]] const auto disabled = bufferedWorld.setEnabled(hidden, false);
+        bufferedWorld.flipBuffers();
+        assert(disabled && bufferedWorld.getSnapshot().getComponent<FooComponent>(hidden) == nullptr);
+        assert(bufferedWorld.getSnapshot().getComponent<FooComponent>(entity) != nullptr);
+        assert(bufferedWorld.getSnapshot().getComponent<BarComponent>(entity) != nullptr);
+    }
+    // Const worlds answer queries without being modified
+    {
+        ecsWorld readWorld;
+        const auto entity = readWorld.makeEntity();
+        [[maybe_unused]] const auto fooHandle = readWorld.makeComponent<FooComponent>(entity);
+        const auto& constWorld = readWorld;
+        {
+            [[maybe_unused]] const auto readPhase = constWorld.beginReadPhase();
+            assert(constWorld.isReadPhase());
+            assert(constWorld.getComponent<FooComponent>(entity)->qwe);
+            assert(constWorld.getComponent<FooComponent>(fooHandle) != nullptr);
+            assert(constWorld.getComponent<BarComponent>(entity) == nullptr);
+            [[maybe_unused]] const auto fooRows = constWorld.getComponents<const FooComponent*>(
+                { { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED } });
+            [[maybe_unused]] const auto barRows = constWorld.getComponents<const FooComponent*, const BarComponent*>(
+                { { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED },
+                  { BarComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED } });
+            assert(fooRows.size() == 1ULL);
+            assert(barRows.empty());
+        }
+        assert(!constWorld.isReadPhase());
+    }
+    // Worker threads stage entities in their own buffers, spliced in later
+    {
+        ecsWorld spawnWorld;
+        spawnWorld.makeGroup<FooComponent, BarComponent>();
+        const auto observer = std::make_shared<FooBarObserver>();
+        spawnWorld.addObserver(observer);
+
+        constexpr auto workerCount = 4ULL;
+        constexpr auto spawnCount = 100ULL;
+        std::vector<ecsSpawnBuffer> buffers(workerCount);
+        std::vector<std::thread> workers;
+        for (auto& buffer : buffers) {
+            workers.emplace_back([&buffer] {
+                for (size_t i = 0; i < spawnCount; ++i) {
+                    const auto entity = buffer.makeEntity();
+                    [[maybe_unused]] const auto fooHandle = buffer.makeComponent<FooComponent>(entity);
+                    if (i % 2ULL == 0ULL) {
+                        [[maybe_unused]] const auto barHandle = buffer.makeComponent<BarComponent>(entity);
+                        [[maybe_unused]] const auto tagged = buffer.addTag<EnemyTag>(entity);
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        [[maybe_unused]] const auto fooBar = spawnWorld.makeComponent<FooComponent>(spawnWorld.makeEntity());
+        for (auto& buffer : buffers) {
+            spawnWorld.spliceSpawnBuffer(buffer);
+            assert(buffer.empty());
+        }
+        spawnWorld.flushObservers();
+        assert(observer->m_added == workerCount * spawnCount / 2ULL);
+
+        [[maybe_unused]] const auto fooRows = spawnWorld.getComponents<FooComponent*>(
+            { { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED } });
+        [[maybe_unused]] const auto enemyRows = spawnWorld.getComponents<FooComponent*, BarComponent*>(
+            { { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED },
+              { BarComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED },
+              { EnemyTag::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED } });
+        assert(fooRows.size() == workerCount * spawnCount + 1ULL);
+        assert(enemyRows.size() == workerCount * spawnCount / 2ULL);
+        for ([[maybe_unused]] const auto& [foo, bar] : enemyRows) {
+            assert(foo->m_entityHandle == bar->m_entityHandle);
+        }
+    }
+    // Managers update many worlds in parallel, relaying messages and migrations
+    {
+        constexpr auto worldCount = 16ULL;
+        ecsWorldManager manager(4ULL);
+        assert(manager.getThreadCount() == 4ULL);
+        std::vector<std::shared_ptr<CountingSystem>> systems;
+        for (size_t i = 0; i < worldCount; ++i) {
+            ecsWorld room;
+            [[maybe_unused]] const auto fooHandle = room.makeComponent<FooComponent>(room.makeEntity());
+            const auto worldIndex = manager.addWorld(std::move(room));
+            systems.emplace_back(std::make_shared<CountingSystem>());
+            manager.getSystems(worldIndex).addSystem(systems.back());
+        }
+        assert(manager.getWorldCount() == worldCount);
+
+        // World 0 spawns into world 1, and hands its own entity to world 2
+        manager.postMessage(0ULL, [&manager](ecsWorld& sender) {
+            manager.postMessage(1ULL, [](ecsWorld& receiver) {
+                [[maybe_unused]] const auto fooHandle = receiver.makeComponent<FooComponent>(receiver.makeEntity());
+            });
+            const auto foo = std::get<0>(sender.getComponents<FooComponent*>(
+                { { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED } })[0]);
+            manager.requestMigration(0ULL, foo->m_entityHandle, 2ULL);
+        });
+        manager.updateWorlds(timeStep);
+        manager.updateWorlds(timeStep);
+        for (size_t i = 3; i < worldCount; ++i) {
+            assert(systems[i]->m_rows == 2ULL);
+        }
+        assert(systems[0]->m_rows == 1ULL);
+        assert(systems[1]->m_rows == 3ULL);
+        assert(systems[2]->m_rows == 3ULL);
+
+        // Chained migrations of one entity in one tick apply in request order
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>> fooQuery = {
+            { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED }
+        };
+        const auto chained = std::get<0>(manager.getWorld(5ULL).getComponents<FooComponent*>(fooQuery)[0]);
+        manager.requestMigration(5ULL, chained->m_entityHandle, 4ULL);
+        manager.requestMigration(4ULL, chained->m_entityHandle, 3ULL);
+        manager.updateWorlds(timeStep);
+        assert(manager.getWorld(3ULL).getComponents<FooComponent*>(fooQuery).size() == 2ULL);
+        assert(manager.getWorld(4ULL).getComponents<FooComponent*>(fooQuery).size() == 1ULL);
+        assert(manager.getWorld(5ULL).getComponents<FooComponent*>(fooQuery).empty());
+    }
+    // Trivial components are copied and destroyed in bulk
+    {
+        ecsWorld trivialWorld;
+        ecsWorld otherWorld;
+        trivialWorld.setDoubleBuffered<PointComponent>();
+        std::vector<EntityHandle> entities;
+        for (auto i = 0; i < 4; ++i) {
+            PointComponent point;
+            point.x = static_cast<float>(i);
+            const ecsBaseComponent* const components[] = { &point };
+            entities.emplace_back(trivialWorld.makeEntity(components, 1ULL));
+        }
+        trivialWorld.removeEntity(entities[0]);
+        trivialWorld.migrateEntityTo(entities[1], otherWorld);
+        trivialWorld.flipBuffers();
+        assert(otherWorld.getComponent<PointComponent>(entities[1])->x == 1.0F);
+        assert(trivialWorld.getComponent<PointComponent>(entities[3])->x == 3.0F);
+        assert(trivialWorld.getSnapshot().getComponent<PointComponent>(entities[2])->x == 2.0F);
+
+        ecsSpawnBuffer buffer;
+        [[maybe_unused]] const auto pointHandle = buffer.makeComponent<PointComponent>(buffer.makeEntity());
+        trivialWorld.spliceSpawnBuffer(buffer);
+        [[maybe_unused]] const auto points = trivialWorld.getComponents<PointComponent*>(
+            { { PointComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED } });
+        assert(points.size() == 3ULL);
+        trivialWorld.clear();
+    }
+    // Static worlds resolve their fixed component set at compile time
+    {
+        using StaticWorld = ecsStaticWorld<FooComponent, BarComponent, PointComponent>;
+        static_assert(StaticWorld::indexOf<PointComponent>() == 2ULL);
+        static_assert(StaticWorld::maskOf<FooComponent, PointComponent>() == 0b101ULL);
+
+        StaticWorld staticWorld;
+        std::vector<EntityHandle> entities;
+        for (auto i = 0; i < 4; ++i) {
+            entities.emplace_back(staticWorld.makeEntity());
+            PointComponent point;
+            point.x = static_cast<float>(i);
+            staticWorld.makeComponent(entities.back(), point);
+            if (i % 2 == 0) {
+                staticWorld.makeComponent<FooComponent>(entities.back());
+            }
+        }
+        [[maybe_unused]] const auto removed = staticWorld.removeEntity(entities[0]);
+        assert(removed);
+        assert(staticWorld.getComponent<FooComponent>(entities[1]) == nullptr);
+        assert(staticWorld.getComponent<PointComponent>(entities[3])->x == 3.0F);
+
+        float sum = 0.0F;
+        staticWorld.forEach<FooComponent, PointComponent>([&sum](FooComponent&, PointComponent& point) {
+            sum += point.x;
+        });
+        assert(sum == 2.0F);
+
+        // Convert to a dynamic world and back again
+        ecsWorld dynamicWorld;
+        staticWorld.exportTo(dynamicWorld);
+        assert(dynamicWorld.getComponent<PointComponent>(entities[2])->x == 2.0F);
+        assert(dynamicWorld.getComponent<FooComponent>(entities[2]) != nullptr);
+        StaticWorld roundTrip;
+        roundTrip.importFrom(dynamicWorld);
+        assert(roundTrip.size() == 3ULL);
+        assert(roundTrip.getComponents<PointComponent>().size() == 3ULL);
+        assert(roundTrip.getComponents<FooComponent>().size() == 1ULL);
+        [[maybe_unused]] const auto removedPoint = roundTrip.removeComponent<PointComponent>(entities[1]);
+        assert(removedPoint);
+        assert(roundTrip.getComponent<PointComponent>(entities[3])->x == 3.0F);
+    }
+    // Disabled entities keep their components but drop out of queries
+    {
+        ecsWorld pausedWorld;
+        std::vector<EntityHandle> entities;
+        for (auto i = 0; i < 5; ++i) {
+            PointComponent point;
+            point.x = static_cast<float>(i);
+            const ecsBaseComponent* const components[] = { &point };
+            entities.emplace_back(pausedWorld.makeEntity(components, 1ULL));
+        }
+        [[maybe_unused]] const auto grouped =
+            pausedWorld.makeGroup({ PointComponent::Runtime_ID, FooComponent::Runtime_ID });
+        for (const auto& pausedHandle : entities) {
+            [[maybe_unused]] const auto fooHandle = pausedWorld.makeComponent<FooComponent>(pausedHandle);
+        }
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>> pointQuery = {
+            { PointComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED }
+        };
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>> groupQuery = {
+            { PointComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED },
+            { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED }
+        };
+
+        [[maybe_unused]] const auto disabledOne = pausedWorld.setEnabled(entities[1], false);
+        assert(disabledOne);
+        [[maybe_unused]] const auto disabledThree = pausedWorld.setEnabled(entities[3], false);
+        assert(disabledThree);
+        assert(!pausedWorld.isEnabled(entities[1]));
+        [[maybe_unused]] const auto active = pausedWorld.getComponents<PointComponent*>(pointQuery);
+        assert(active.size() == 3ULL);
+        for ([[maybe_unused]] const auto& [point] : active) {
+            assert(point->x != 1.0F && point->x != 3.0F);
+        }
+        [[maybe_unused]] const auto activeGroup = pausedWorld.getComponents<PointComponent*, FooComponent*>(groupQuery);
+        assert(activeGroup.size() == 3ULL);
+
+        // Structural changes keep the disabled rows at the tail
+        [[maybe_unused]] const auto barHandle = pausedWorld.makeComponent<BarComponent>(entities[1]);
+        [[maybe_unused]] const auto removedFirst = pausedWorld.removeEntity(entities[0]);
+        assert(removedFirst);
+        [[maybe_unused]] const auto removedFoo = pausedWorld.removeComponent<FooComponent>(entities[3]);
+        assert(removedFoo);
+        [[maybe_unused]] const auto remaining = pausedWorld.getComponents<PointComponent*>(pointQuery);
+        assert(remaining.size() == 2ULL);
+        assert(pausedWorld.getComponent<PointComponent>(entities[3])->x == 3.0F);
+
+        [[maybe_unused]] const auto enabledOne = pausedWorld.setEnabled(entities[1], true);
+        assert(enabledOne);
+        [[maybe_unused]] const auto enabledThree = pausedWorld.setEnabled(entities[3], true);
+        assert(enabledThree);
+        [[maybe_unused]] const auto restored = pausedWorld.getComponents<PointComponent*>(pointQuery);
+        assert(restored.size() == 4ULL);
+        [[maybe_unused]] const auto restoredGroup =
+            pausedWorld.getComponents<PointComponent*, FooComponent*>(groupQuery);
+        assert(restoredGroup.size() == 3ULL);
+        assert(pausedWorld.getComponent<PointComponent>(entities[1])->x == 1.0F);
+        assert(pausedWorld.getComponent<BarComponent>(entities[1]) != nullptr);
+    }
+    // Evicted entities are written to a cold store and restored intact
+    {
+        ecsWorld residentWorld;
+        ecsColdStore store("ecsColdStore.bin");
+        assert(store.isOpen());
+        std::vector<EntityHandle> entities;
+        std::vector<ComponentHandle> pointHandles;
+        for (auto i = 0; i < 4; ++i) {
+            entities.emplace_back(residentWorld.makeEntity());
+            pointHandles.emplace_back(residentWorld.makeComponent<PointComponent>(entities.back()));
+            residentWorld.getComponent<PointComponent>(entities.back())->x = static_cast<float>(i);
+        }
+        [[maybe_unused]] const auto tagged = residentWorld.addTag<FrozenTag>(entities[1]);
+        [[maybe_unused]] const auto disabled = residentWorld.setEnabled(entities[2], false);
+        [[maybe_unused]] const auto configHandle = residentWorld.makeComponent<ConfigComponent>(entities[3]);
+
+        // Entities with non-trivial component classes stay resident
+        [[maybe_unused]] const auto evicted = residentWorld.evictEntities(entities, store);
+        assert(evicted == 3ULL);
+        assert(store.size() == 3ULL);
+        assert(residentWorld.getEntity(entities[1]) == nullptr);
+        assert(residentWorld.getResidency(entities[1]) == ecsWorld::Residency::EVICTED);
+        assert(residentWorld.getResidency(entities[3]) == ecsWorld::Residency::RESIDENT);
+        assert(residentWorld.getResidency(EntityHandle()) == ecsWorld::Residency::UNKNOWN);
+
+        [[maybe_unused]] const auto restored = residentWorld.restoreEntities({ entities[1], entities[2] }, store);
+        assert(restored == 2ULL);
+        assert(store.size() == 1ULL);
+        assert(residentWorld.getComponent<PointComponent>(entities[1])->x == 1.0F);
+        assert(residentWorld.getComponent<PointComponent>(pointHandles[2]) != nullptr);
+        assert(residentWorld.hasType<FrozenTag>(entities[1]));
+        assert(!residentWorld.isEnabled(entities[2]));
+        assert(residentWorld.getResidency(entities[0]) == ecsWorld::Residency::EVICTED);
+
+        // Records that run past their end, or name unknown types, are skipped
+        const auto corrupt = [](const std::streamoff offset, const auto value) {
+            std::fstream file("ecsColdStore.bin", std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp(offset);
+            file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        };
+        const auto countOffset = static_cast<std::streamoff>(sizeof(uint8_t) + sizeof(uint32_t) * 2ULL);
+        corrupt(countOffset, std::numeric_limits<uint32_t>::max());
+        [[maybe_unused]] const auto truncated = residentWorld.restoreEntities({ entities[0] }, store);
+        assert(truncated == 0ULL);
+        corrupt(countOffset, uint32_t(1U));
+        corrupt(countOffset + static_cast<std::streamoff>(sizeof(uint32_t)), std::numeric_limits<ComponentID>::max());
+        [[maybe_unused]] const auto unknown = residentWorld.restoreEntities({ entities[0] }, store);
+        assert(unknown == 0ULL);
+        assert(residentWorld.getEntity(entities[0]) == nullptr);
+        assert(residentWorld.getResidency(entities[0]) == ecsWorld::Residency::EVICTED);
+    }
+    // Queries are planned from signature counts and re-planned as the world changes
+    {
+        ecsWorld plannedWorld;
+        std::vector<EntityHandle> entities;
+        for (auto i = 0; i < 64; ++i) {
+            entities.emplace_back(plannedWorld.makeEntity());
+            [[maybe_unused]] const auto pointHandle = plannedWorld.makeComponent<PointComponent>(entities.back());
+            if (i % 8 == 0) {
+                [[maybe_unused]] const auto fooHandle = plannedWorld.makeComponent<FooComponent>(entities.back());
+                [[maybe_unused]] const auto tagged = plannedWorld.addTag<FrozenTag>(entities.back());
+            }
+        }
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>> wideQuery = {
+            { BarComponent::Runtime_ID, ecsSystem::RequirementsFlag::OPTIONAL },
+            { PointComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED },
+            { FrozenTag::Runtime_ID, ecsSystem::RequirementsFlag::EXCLUDE }
+        };
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>> narrowQuery = {
+            { BarComponent::Runtime_ID, ecsSystem::RequirementsFlag::OPTIONAL },
+            { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED },
+            { PointComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED }
+        };
+        assert(plannedWorld.estimateMatches(wideQuery) == 56ULL);
+        assert(plannedWorld.estimateMatches(narrowQuery) == 8ULL);
+
+        // Small worlds drive from the smallest pool, even one every entity owns
+        assert(plannedWorld.getQueryDriver(wideQuery) == PointComponent::Runtime_ID);
+        assert(plannedWorld.getQueryDriver(narrowQuery) == FooComponent::Runtime_ID);
+
+        // Optional terms ahead of the driving type still land in their own columns
+        [[maybe_unused]] const auto wide =
+            plannedWorld.getComponents<BarComponent*, PointComponent*, FrozenTag*>(wideQuery);
+        assert(wide.size() == 56ULL);
+        [[maybe_unused]] const auto narrow =
+            plannedWorld.getComponents<BarComponent*, FooComponent*, PointComponent*>(narrowQuery);
+        assert(narrow.size() == 8ULL);
+        for ([[maybe_unused]] const auto& [bar, foo, point] : narrow) {
+            assert(bar == nullptr && foo != nullptr && point != nullptr);
+            assert(foo->m_entityHandle == point->m_entityHandle);
+        }
+
+        // Growing the narrow pool re-plans it
+        for (auto i = 0; i < 64; ++i) {
+            [[maybe_unused]] const auto fooHandle = plannedWorld.makeComponent<FooComponent>(entities[i]);
+        }
+        [[maybe_unused]] const auto grown =
+            plannedWorld.getComponents<BarComponent*, FooComponent*, PointComponent*>(narrowQuery);
+        assert(grown.size() == 64ULL);
+        [[maybe_unused]] const auto removed = plannedWorld.removeEntity(entities[0]);
+        assert(removed);
+        assert(plannedWorld.estimateMatches(narrowQuery) == 63ULL);
+
+        // Large worlds only scan signatures once lookups into a common pool cost more
+        ecsWorld largeWorld;
+        for (auto i = 0; i < 4096; ++i) {
+            const auto entity = largeWorld.makeEntity();
+            [[maybe_unused]] const auto pointHandle = largeWorld.makeComponent<PointComponent>(entity);
+            if (i % 8 == 0) {
+                [[maybe_unused]] const auto fooHandle = largeWorld.makeComponent<FooComponent>(entity);
+            }
+        }
+        assert(largeWorld.getQueryDriver(wideQuery) == ComponentID(-1));
+        assert(largeWorld.getQueryDriver(narrowQuery) == FooComponent::Runtime_ID);
+        [[maybe_unused]] const auto scanned =
+            largeWorld.getComponents<BarComponent*, PointComponent*, FrozenTag*>(wideQuery);
+        assert(scanned.size() == 4096ULL);
+        [[maybe_unused]] const auto driven =
+            largeWorld.getComponents<BarComponent*, FooComponent*, PointComponent*>(narrowQuery);
+        assert(driven.size() == 512ULL);
+
+        // Systems keep their plans, which writers refresh as pools drift
+        PointFooSystem pointFooSystem;
+        largeWorld.updateSystem(pointFooSystem, 1.0);
+        assert(pointFooSystem.m_rows == 512ULL);
+        assert(largeWorld.getQueryDriver(pointFooSystem.getComponentTypes()) == FooComponent::Runtime_ID);
+        for ([[maybe_unused]] const auto& [bar, point, frozen] : scanned) {
+            [[maybe_unused]] const auto fooHandle = largeWorld.makeComponent<FooComponent>(point->m_entityHandle);
+        }
+        largeWorld.updateSystem(pointFooSystem, 1.0);
+        assert(pointFooSystem.m_rows == 4096ULL);
+    }
+    // Recorded traces replay the same mutations and queries with stand-in classes
+    {
+        ecsTraceRecorder recorder;
+        ecsWorld tracedWorld;
+        tracedWorld.setRecorder(&recorder);
+        std::vector<EntityHandle> entities;
+        for (auto i = 0; i < 16; ++i) {
+            entities.emplace_back(tracedWorld.makeEntity());
+            [[maybe_unused]] const auto pointHandle = tracedWorld.makeComponent<PointComponent>(entities.back());
+            if (i % 2 == 0) {
+                [[maybe_unused]] const auto fooHandle = tracedWorld.makeComponent<FooComponent>(entities.back());
+            }
+        }
+        [[maybe_unused]] const auto tagged = tracedWorld.addTag<FrozenTag>(entities[2]);
+        [[maybe_unused]] const auto parented = tracedWorld.setParent(entities[5], entities[4]);
+        [[maybe_unused]] const auto disabled = tracedWorld.setEnabled(entities[6], false);
+        [[maybe_unused]] const auto removed = tracedWorld.removeComponent<PointComponent>(entities[8]);
+        [[maybe_unused]] const auto removedParent = tracedWorld.removeEntity(entities[4]);
+        assert(removedParent);
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>> traceQuery = {
+            { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED },
+            { PointComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED },
+            { FrozenTag::Runtime_ID, ecsSystem::RequirementsFlag::EXCLUDE }
+        };
+        [[maybe_unused]] const auto traced =
+            tracedWorld.getComponents<FooComponent*, PointComponent*, FrozenTag*>(traceQuery);
+        assert(traced.size() == 4ULL);
+
+        // Modes, compaction, change marks, singletons, shared values and event flips are recorded too
+        tracedWorld.setTombstoneMode(true);
+        tracedWorld.setDoubleBuffered<PointComponent>();
+        [[maybe_unused]] const auto marked = tracedWorld.markChanged<PointComponent>(entities[0]);
+        assert(marked);
+        [[maybe_unused]] const auto sorted = tracedWorld.sortHierarchy<PointComponent>();
+        [[maybe_unused]] const auto* singleton = tracedWorld.makeSingleton<BarComponent>();
+        [[maybe_unused]] const auto singletonRemoved = tracedWorld.removeSingleton<BarComponent>();
+        const auto shared = tracedWorld.makeSharedComponent<BarComponent>();
+        [[maybe_unused]] const auto sharedSet = tracedWorld.setSharedComponent(entities[1], shared);
+        [[maybe_unused]] const auto sharedUnset = tracedWorld.unsetSharedComponent<BarComponent>(entities[1]);
+        assert(sharedSet && sharedUnset);
+        [[maybe_unused]] const auto sharedRemoved = tracedWorld.removeSharedComponent(shared);
+        tracedWorld.flipEvents();
+        [[maybe_unused]] const auto removedPoint = tracedWorld.removeComponent<PointComponent>(entities[10]);
+        [[maybe_unused]] const auto removedFoo = tracedWorld.removeComponent<FooComponent>(entities[12]);
+        [[maybe_unused]] const auto compacted = tracedWorld.compactComponents(1ULL);
+        assert(tracedWorld.getTombstoneCount() == 1ULL);
+
+        // The recorder follows a moved world, the moved-from one records nothing more
+        ecsWorld movedWorld(std::move(tracedWorld));
+        const auto operationCount = recorder.getOperationCount();
+        [[maybe_unused]] const auto reused = tracedWorld.makeEntity();
+        assert(recorder.getOperationCount() == operationCount);
+        tracedWorld = std::move(movedWorld);
+        [[maybe_unused]] const auto reusedAgain = movedWorld.makeEntity();
+        assert(recorder.getOperationCount() == operationCount);
+        tracedWorld.setRecorder(nullptr);
+
+        ecsTraceReplayer replayer;
+        [[maybe_unused]] const auto saved = recorder.save("ecsTrace.bin");
+        assert(saved);
+        [[maybe_unused]] const auto loaded = replayer.load(std::string("ecsTrace.bin"));
+        assert(loaded);
+        ecsTraceReplayer otherReplayer;
+        [[maybe_unused]] const auto otherLoaded = otherReplayer.load(std::string("ecsTrace.bin"));
+        assert(otherLoaded);
+        std::remove("ecsTrace.bin");
+        ecsWorld replayWorld;
+        [[maybe_unused]] const auto replayed = replayer.replay(replayWorld);
+        assert(replayed);
+        assert(replayer.getOperationCount() == recorder.getOperationCount());
+        assert(replayer.getQueryRowCount() == traced.size());
+        assert(replayWorld.getTombstoneCount() == tracedWorld.getTombstoneCount());
+        [[maybe_unused]] const auto truncated = replayer.load(std::vector<uint8_t>{ 'M', 'E', 'C', 'S' });
+        assert(!truncated);
+
+        // Another replayer reuses the registered stand-ins
+        ecsWorld otherWorld;
+        [[maybe_unused]] const auto otherReplayed = otherReplayer.replay(otherWorld);
+        assert(otherReplayed);
+        assert(otherReplayer.getQueryRowCount() == traced.size());
+
+        // Oversized numbers and counts are malformed instead of allocated
+        const std::vector<uint8_t> header{ 'M', 'E', 'C', 'S', 'T', 'R', 'C', 1U };
+        for (uint8_t operation = 0U; operation <= static_cast<uint8_t>(ecsTraceRecorder::Operation::FLIP_EVENTS);
+             ++operation) {
+            auto hostile = header;
+            hostile.emplace_back(operation);
+            for (auto varint = 0; varint < 2; ++varint) {
+                hostile.insert(hostile.end(), 9ULL, uint8_t(0xFFU));
+                hostile.emplace_back(uint8_t(0x01U));
+            }
+            ecsTraceReplayer hostileReplayer;
+            ecsWorld hostileWorld;
+            [[maybe_unused]] const auto hostileLoaded = hostileReplayer.load(hostile);
+            assert(hostileLoaded);
+            [[maybe_unused]] const auto hostileReplayed = hostileReplayer.replay(hostileWorld);
+            assert(!hostileReplayed);
+        }
+    }
+    // Sorted queries return rows in key order, re-sorting incrementally between calls
+    {
+        ecsWorld sortedWorld;
+        std::vector<EntityHandle> entities;
+        for (auto i = 0; i < 200; ++i) {
+            entities.emplace_back(sortedWorld.makeEntity());
+            PointComponent point;
+            point.x = static_cast<float>(i);
+            point.y = static_cast<float>((i * 37) % 50) - 25.0F;
+            [[maybe_unused]] const auto pointHandle = sortedWorld.makeComponent(entities.back(), &point);
+        }
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>> pointQuery = {
+            { PointComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED }
+        };
+        const auto byDepth = [](const PointComponent* point) { return point->y; };
+        [[maybe_unused]] const auto isSorted = [](const std::vector<std::tuple<PointComponent*>>& rows) {
+            for (size_t i = 1; i < rows.size(); ++i) {
+                const auto* previous = std::get<0>(rows[i - 1]);
+                const auto* current = std::get<0>(rows[i]);
+                if (previous->y > current->y || (previous->y == current->y && previous->x > current->x)) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        ecsWorld::SortOrder order;
+        [[maybe_unused]] const auto sorted = sortedWorld.getSortedComponents<PointComponent*>(pointQuery, byDepth);
+        assert(sorted.size() == 200ULL && isSorted(sorted));
+        [[maybe_unused]] const auto first =
+            sortedWorld.getSortedComponents<PointComponent*>(pointQuery, byDepth, &order);
+        assert(isSorted(first) && order.getFullSortCount() == 1ULL);
+
+        // A few changed keys only need a few moves
+        sortedWorld.getComponent<PointComponent>(entities[10])->y = -30.0F;
+        sortedWorld.getComponent<PointComponent>(entities[20])->y = 30.0F;
+        [[maybe_unused]] const auto second =
+            sortedWorld.getSortedComponents<PointComponent*>(pointQuery, byDepth, &order);
+        assert(isSorted(second) && std::get<0>(second.front())->x == 10.0F && std::get<0>(second.back())->x == 20.0F);
+        assert(order.getIncrementalSortCount() == 1ULL && order.getFullSortCount() == 1ULL);
+
+        // Reversing every key exceeds the budget, falling back to a full sort
+        for (auto& [point] : sortedWorld.getComponents<PointComponent*>(pointQuery)) {
+            point->y = -point->y;
+        }
+        [[maybe_unused]] const auto third =
+            sortedWorld.getSortedComponents<PointComponent*>(pointQuery, byDepth, &order);
+        assert(isSorted(third) && order.getFullSortCount() == 2ULL);
+
+        // Equal keys fall back to query order, not the order left by the last call
+        for (auto& [point] : sortedWorld.getComponents<PointComponent*>(pointQuery)) {
+            point->y = 0.0F;
+        }
+        [[maybe_unused]] const auto tied =
+            sortedWorld.getSortedComponents<PointComponent*>(pointQuery, byDepth, &order);
+        assert(isSorted(tied));
+        [[maybe_unused]] const auto byIndex = sortedWorld.getSortedComponents<PointComponent*>(
+            pointQuery, [](const PointComponent* point) { return -static_cast<int>(point->x); });
+        assert(std::get<0>(byIndex.front())->x == 199.0F && std::get<0>(byIndex.back())->x == 0.0F);
+    }
+    // Reductions combine in a fixed order, so results don't depend on the thread count
+    {
+        ecsWorld reducedWorld;
+        for (auto i = 0; i < 5000; ++i) {
+            PointComponent point;
+            point.x = 1.0F / static_cast<float>(i + 1);
+            point.y = static_cast<float>(i % 7);
+            [[maybe_unused]] const auto pointHandle = reducedWorld.makeComponent(reducedWorld.makeEntity(), &point);
+        }
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>> pointQuery = {
+            { PointComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED }
+        };
+        const auto toX = [](const std::vector<ecsBaseComponent*>& row) {
+            return static_cast<double>(static_cast<PointComponent*>(row[0])->x);
+        };
+        const auto sum = [](const double a, const double b) { return a + b; };
+        [[maybe_unused]] const auto serial = reducedWorld.reduce<double>(pointQuery, toX, sum, 0.0, 1ULL);
+        [[maybe_unused]] const auto parallel = reducedWorld.reduce<double>(pointQuery, toX, sum, 0.0, 4ULL);
+        [[maybe_unused]] const auto wide = reducedWorld.reduce<double>(pointQuery, toX, sum, 0.0, 13ULL);
+        assert(serial == parallel && serial == wide && serial > 9.0 && serial < 10.0);
+
+        // Any associative combination works, such as a bounding range
+        [[maybe_unused]] const auto range = reducedWorld.reduce<std::pair<float, float>>(
+            pointQuery,
+            [](const std::vector<ecsBaseComponent*>& row) {
+                const auto y = static_cast<PointComponent*>(row[0])->y;
+                return std::make_pair(y, y);
+            },
+            [](const std::pair<float, float>& a, const std::pair<float, float>& b) {
+                return std::make_pair(std::min(a.first, b.first), std::max(a.second, b.second));
+            },
+            { 100.0F, -100.0F }, 3ULL);
+        assert(range.first == 0.0F && range.second == 6.0F);
+        [[maybe_unused]] const auto none = ecsWorld().reduce<double>(pointQuery, toX, sum);
+        assert(none == 0.0);
+    }
+    // Event channels pass events between systems, readable after the frame they're sent in
+    {
+        struct DamageEvent {
+            EntityHandle m_target;
+            int m_amount = 0;
+        };
+        ecsWorld eventWorld;
+        auto& damage = eventWorld.getEventChannel<DamageEvent>();
+        assert(eventWorld.findEventChannel<DamageEvent>() == &damage);
+        assert(eventWorld.findEventChannel<std::string>() == nullptr);
+
+        // Made channels are fetched without writing, so senders may fetch them while reading
+        std::vector<std::thread> senders;
+        {
+            [[maybe_unused]] const auto readPhase = eventWorld.beginReadPhase();
+            for (auto i = 0; i < 4; ++i) {
+                senders.emplace_back([&eventWorld]() {
+                    auto& channel = eventWorld.getEventChannel<DamageEvent>();
+                    for (auto j = 0; j < 5000; ++j) {
+                        channel.send(DamageEvent{ EntityHandle(), j % 10 });
+                    }
+                });
+            }
+            for (auto& sender : senders) {
+                sender.join();
+            }
+        }
+        assert(damage.getPendingCount() == 20000ULL && damage.getReadableCount() == 0ULL);
+        eventWorld.flipEvents();
+        assert(damage.getPendingCount() == 0ULL && damage.getReadableCount() == 20000ULL);
+
+        // Each reader keeps its own position
+        ecsEventChannel<DamageEvent>::Reader first;
+        ecsEventChannel<DamageEvent>::Reader second;
+        int total = 0;
+        [[maybe_unused]] const auto firstRead =
+            damage.read(first, [&total](const DamageEvent& event) { total += event.m_amount; });
+        assert(firstRead == 20000ULL && total == 90000);
+        [[maybe_unused]] const auto reread = damage.read(first, [](const DamageEvent&) {});
+        assert(reread == 0ULL);
+        damage.send(DamageEvent{ EntityHandle(), 1 });
+        [[maybe_unused]] const auto secondRead = damage.read(second, [](const DamageEvent&) {});
+        assert(secondRead == 20000ULL);
+
+        // Events last a single frame, whether read or not
+        eventWorld.flipEvents();
+        [[maybe_unused]] const auto nextRead = damage.read(first, [](const DamageEvent&) {});
+        assert(nextRead == 1ULL);
+        eventWorld.flipEvents();
+        assert(damage.getReadableCount() == 0ULL);
+        auto& names = eventWorld.getEventChannel<std::string>();
+        names.send("collision");
+        eventWorld.clear();
+        eventWorld.flipEvents();
+        assert(names.getReadableCount() == 0ULL);
+    }
+    // Paged and sparse classes keep components in place, queries probe them from dense drivers
+    {
+        ecsWorld storedWorld;
+        std::vector<EntityHandle> entities;
+        for (auto i = 0; i < 300; ++i) {
+            entities.emplace_back(storedWorld.makeEntity());
+            [[maybe_unused]] const auto fooHandle = storedWorld.makeComponent<FooComponent>(entities.back());
+            [[maybe_unused]] const auto debugHandle = storedWorld.makeComponent<DebugComponent>(entities.back());
+            if (i % 100 == 0) {
+                ScriptComponent script;
+                script.lines.assign(static_cast<size_t>(i) + 1ULL, i);
+                [[maybe_unused]] const auto scriptHandle = storedWorld.makeComponent(entities.back(), &script);
+            }
+        }
+
+        // Removals leave holes rather than moving the remaining components
+        auto* kept = storedWorld.getComponent<DebugComponent>(entities[299]);
+        kept->samples[0] = 7.0F;
+        for (auto i = 0; i < 200; ++i) {
+            [[maybe_unused]] const auto removed = storedWorld.removeComponent<DebugComponent>(entities[i]);
+        }
+        assert(storedWorld.getComponent<DebugComponent>(entities[299]) == kept && kept->samples[0] == 7.0F);
+        [[maybe_unused]] const auto refilled = storedWorld.makeComponent<DebugComponent>(entities[0]);
+        assert(storedWorld.getComponent(refilled) == storedWorld.getComponent<DebugComponent>(entities[0]));
+
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>> scriptedQuery = {
+            { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED },
+            { ScriptComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED },
+            { DebugComponent::Runtime_ID, ecsSystem::RequirementsFlag::OPTIONAL }
+        };
+        [[maybe_unused]] const auto scripted =
+            storedWorld.getComponents<FooComponent*, ScriptComponent*, DebugComponent*>(scriptedQuery);
+        assert(scripted.size() == 3ULL);
+        for ([[maybe_unused]] const auto& [foo, script, debug] : scripted) {
+            assert(foo->m_entityHandle == script->m_entityHandle);
+            assert(script->lines.size() == static_cast<size_t>(script->lines.front()) + 1ULL);
+            assert((debug == nullptr) == (script->lines.front() == 100));
+        }
+        [[maybe_unused]] const auto scriptsOnly = storedWorld.getComponents<ScriptComponent*>(
+            { { ScriptComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED } });
+        assert(scriptsOnly.size() == 3ULL);
+
+        // Disabled owners drop out, stored classes can't be grouped, buffered or sorted
+        [[maybe_unused]] const auto disabled = storedWorld.setEnabled(entities[100], false);
+        [[maybe_unused]] const auto enabledScripted =
+            storedWorld.getComponents<FooComponent*, ScriptComponent*, DebugComponent*>(scriptedQuery);
+        assert(enabledScripted.size() == 2ULL);
+        [[maybe_unused]] const auto grouped = storedWorld.makeGroup<FooComponent, ScriptComponent>();
+        assert(!grouped);
+        [[maybe_unused]] const auto buffered = storedWorld.setDoubleBuffered(DebugComponent::Runtime_ID);
+        [[maybe_unused]] const auto sorted = storedWorld.sortHierarchy<ScriptComponent>();
+        assert(!buffered && !sorted);
+
+        // Stored components travel with migrating entities and are freed with their owners
+        ecsWorld otherWorld;
+        storedWorld.migrateEntityTo(entities[200], otherWorld);
+        assert(otherWorld.getComponent<ScriptComponent>(entities[200])->lines.size() == 201ULL);
+        assert(storedWorld.getComponent<ScriptComponent>(entities[200]) == nullptr);
+        [[maybe_unused]] const auto removed = storedWorld.removeEntity(entities[0]);
+        assert(removed);
+    }
+    // Tombstoned removals leave rows in place, compaction later reclaims them in bulk
+    {
+        ecsWorld tombWorld;
+        tombWorld.makeGroup<FooComponent, BarComponent>();
+        tombWorld.setTombstoneMode(true);
+        std::vector<EntityHandle> entities;
+        for (auto i = 0; i < 100; ++i) {
+            entities.emplace_back(tombWorld.makeEntity());
+            NameComponent name;
+            name.name.assign(32ULL, static_cast<char>('a' + i % 26));
+            [[maybe_unused]] const auto nameHandle = tombWorld.makeComponent(entities.back(), &name);
+            [[maybe_unused]] const auto fooHandle = tombWorld.makeComponent<FooComponent>(entities.back());
+            if (i % 2 == 0) {
+                [[maybe_unused]] const auto barHandle = tombWorld.makeComponent<BarComponent>(entities.back());
+            }
+        }
+        [[maybe_unused]] const auto disabledA = tombWorld.setEnabled(entities[49], false);
+        [[maybe_unused]] const auto disabledB = tombWorld.setEnabled(entities[98], false);
+        [[maybe_unused]] const auto disabledC = tombWorld.setEnabled(entities[99], false);
+
+        // Despawning moves no surviving component
+        [[maybe_unused]] auto* kept = tombWorld.getComponent<NameComponent>(entities[97]);
+        for (auto i = 0; i < 50; ++i) {
+            [[maybe_unused]] const auto removed = tombWorld.removeEntity(entities[i]);
+        }
+        assert(tombWorld.getComponent<NameComponent>(entities[97]) == kept);
+        assert(tombWorld.getTombstoneCount() == 125ULL);
+        [[maybe_unused]] const auto countRows = [&tombWorld]() {
+            const auto names = tombWorld.getComponents<NameComponent*>(
+                { { NameComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED } });
+            const auto fooNames = tombWorld.getComponents<FooComponent*, NameComponent*>(
+                { { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED },
+                  { NameComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED } });
+            const auto fooBars = tombWorld.getComponents<FooComponent*, BarComponent*>(
+                { { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED },
+                  { BarComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED } });
+            for ([[maybe_unused]] const auto& [name] : names) {
+                assert(name->name.size() == 32ULL && tombWorld.isEnabled(name->m_entityHandle));
+            }
+            assert(names.size() == fooNames.size());
+            return std::make_pair(names.size(), fooBars.size());
+        };
+        assert(countRows() == std::make_pair(size_t(48ULL), size_t(24ULL)));
+
+        // Rows keep moving in and out of the disabled tail and groups around tombstones
+        [[maybe_unused]] const auto enabled = tombWorld.setEnabled(entities[98], true);
+        entities.emplace_back(tombWorld.makeEntity());
+        [[maybe_unused]] const auto nameHandle = tombWorld.makeComponent<NameComponent>(entities.back());
+        [[maybe_unused]] const auto fooHandle = tombWorld.makeComponent<FooComponent>(entities.back());
+        [[maybe_unused]] const auto barHandle = tombWorld.makeComponent<BarComponent>(entities.back());
+        tombWorld.getComponent<NameComponent>(entities.back())->name.assign(32ULL, 'z');
+        assert(countRows() == std::make_pair(size_t(50ULL), size_t(26ULL)));
+
+        // Flipping compacts buffered pools, budgeted steps then reach every other pool
+        tombWorld.setDoubleBuffered<NameComponent>();
+        tombWorld.flipBuffers();
+        assert(tombWorld.getTombstoneCount() == 75ULL);
+        [[maybe_unused]] const auto firstStep = tombWorld.compactComponents(1ULL);
+        assert(firstStep != 0ULL && tombWorld.getTombstoneCount() != 0ULL);
+        while (tombWorld.compactComponents(1ULL) != 0ULL) {
+        }
+        assert(tombWorld.getTombstoneCount() == 0ULL);
+        assert(tombWorld.getComponent<NameComponent>(entities[97])->name == std::vector<char>(32ULL, 't'));
+        assert(countRows() == std::make_pair(size_t(50ULL), size_t(26ULL)));
+        [[maybe_unused]] const auto reenabled = tombWorld.setEnabled(entities[99], true);
+        assert(countRows() == std::make_pair(size_t(51ULL), size_t(26ULL)));
+
+        // Leaving tombstone mode compacts at once, removals swap again
+        [[maybe_unused]] const auto removedLater = tombWorld.removeEntity(entities[60]);
+        tombWorld.setTombstoneMode(false);
+        assert(tombWorld.getTombstoneCount() == 0ULL);
+        [[maybe_unused]] const auto removedSwapped = tombWorld.removeEntity(entities[61]);
+        assert(countRows() == std::make_pair(size_t(49ULL), size_t(25ULL)));
+    }
+    // Change filters only yield rows written or added since the system's last run
+    {
+        ecsWorld changeWorld;
+        std::vector<EntityHandle> entities;
+        for (auto i = 0; i < 1000; ++i) {
+            entities.emplace_back(changeWorld.makeEntity());
+            [[maybe_unused]] const auto fooHandle = changeWorld.makeComponent<FooComponent>(entities.back());
+            [[maybe_unused]] const auto pointHandle = changeWorld.makeComponent<PointComponent>(entities.back());
+        }
+        PointFilterSystem changed(ecsSystem::RequirementsFlag::CHANGED);
+        PointFilterSystem added(ecsSystem::RequirementsFlag::ADDED);
+        const auto countChanged = [&changeWorld](PointFilterSystem& filterSystem) {
+            filterSystem.m_rows = 0ULL;
+            changeWorld.updateSystem(filterSystem, 0.0);
+            return filterSystem.m_rows;
+        };
+        [[maybe_unused]] const auto firstChanged = countChanged(changed);
+        [[maybe_unused]] const auto firstAdded = countChanged(added);
+        assert(firstChanged == 1000ULL && firstAdded == 1000ULL);
+        [[maybe_unused]] const auto idleChanged = countChanged(changed);
+        [[maybe_unused]] const auto idleAdded = countChanged(added);
+        assert(idleChanged == 0ULL && idleAdded == 0ULL);
+
+        // Explicit marks and new components are reported once
+        [[maybe_unused]] const auto markedA = changeWorld.markChanged<PointComponent>(entities[5]);
+        [[maybe_unused]] const auto markedB = changeWorld.markChanged<PointComponent>(entities[500]);
+        for (auto i = 0; i < 2; ++i) {
+            entities.emplace_back(changeWorld.makeEntity());
+            [[maybe_unused]] const auto pointHandle = changeWorld.makeComponent<PointComponent>(entities.back());
+        }
+        [[maybe_unused]] const auto markedChanged = countChanged(changed);
+        [[maybe_unused]] const auto newAdded = countChanged(added);
+        assert(markedChanged == 4ULL && newAdded == 2ULL);
+        [[maybe_unused]] const auto reportedOnce = countChanged(changed);
+        assert(reportedOnce == 0ULL);
+
+        // Queries may filter against any tick, unfiltered terms are looked up as usual
+        const auto tick = changeWorld.getChangeTick();
+        [[maybe_unused]] const auto markedC = changeWorld.markChanged<PointComponent>(entities[7]);
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>> recentQuery = {
+            { FooComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED },
+            { PointComponent::Runtime_ID, ecsSystem::RequirementsFlag::CHANGED }
+        };
+        [[maybe_unused]] const auto recent =
+            changeWorld.getComponents<FooComponent*, PointComponent*>(recentQuery, tick - 1ULL);
+        assert(recent.size() == 1ULL && std::get<1>(recent.front())->m_entityHandle == entities[7]);
+
+        // The filtered pool drives once its changed chunks are fewer rows than the smallest pool
+        assert(changeWorld.getQueryDriver(recentQuery) == FooComponent::Runtime_ID);
+        assert(changeWorld.getQueryDriver(recentQuery, tick - 1ULL) == PointComponent::Runtime_ID);
+
+        // Writers mark what they write for the systems after them
+        DriftSystem drift;
+        changeWorld.updateSystem(drift, 1.0);
+        [[maybe_unused]] const auto driftChanged = countChanged(changed);
+        [[maybe_unused]] const auto driftAdded = countChanged(added);
+        assert(driftChanged == 1002ULL && driftAdded == 0ULL);
+        assert(changeWorld.getComponent<PointComponent>(entities[0])->x == 1.0F);
+
+        // Rows moving into unchanged chunks take their ticks along
+        [[maybe_unused]] const auto markedD = changeWorld.markChanged<PointComponent>(entities.back());
+        [[maybe_unused]] const auto removed = changeWorld.removeEntity(entities[0]);
+        [[maybe_unused]] const auto movedChanged = countChanged(changed);
+        assert(movedChanged == 1ULL);
+        [[maybe_unused]] const auto disabled = changeWorld.setEnabled(entities[1], false);
+        [[maybe_unused]] const auto markedE = changeWorld.markChanged<PointComponent>(entities[999]);
+        [[maybe_unused]] const auto enabled = changeWorld.setEnabled(entities[1], true);
+        [[maybe_unused]] const auto swappedChanged = countChanged(changed);
+        assert(swappedChanged == 1ULL);
+    }
+    // Component references resolve from their cache until components of their class move
+    {
+        ecsWorld refWorld;
+        std::vector<EntityHandle> entities;
+        for (auto i = 0; i < 10; ++i) {
+            entities.emplace_back(refWorld.makeEntity());
+            [[maybe_unused]] const auto fooHandle = refWorld.makeComponent<FooComponent>(entities.back());
+            [[maybe_unused]] const auto pointHandle = refWorld.makeComponent<PointComponent>(entities.back());
+        }
+        ComponentRef<PointComponent> ref(entities[3]);
+        ComponentRef<PointComponent> lastRef(entities[9]);
+        [[maybe_unused]] auto* point = ref.resolve(refWorld);
+        [[maybe_unused]] auto* lastPoint = lastRef.resolve(refWorld);
+        assert(point != nullptr && point == refWorld.getComponent<PointComponent>(entities[3]));
+
+        // Changes to other classes or to values keep the version
+        [[maybe_unused]] const auto version = refWorld.getStructuralVersion(PointComponent::Runtime_ID);
+        [[maybe_unused]] const auto barHandle = refWorld.makeComponent<BarComponent>(entities[3]);
+        [[maybe_unused]] const auto marked = refWorld.markChanged<PointComponent>(entities[3]);
+        assert(refWorld.getStructuralVersion(PointComponent::Runtime_ID) == version);
+        [[maybe_unused]] auto* cached = ref.resolve(refWorld);
+        assert(cached == point);
+
+        // Removals move the last row, references then find it again
+        [[maybe_unused]] const auto removed = refWorld.removeEntity(entities[0]);
+        assert(refWorld.getStructuralVersion(PointComponent::Runtime_ID) != version);
+        [[maybe_unused]] auto* moved = lastRef.resolve(refWorld);
+        assert(moved != lastPoint && moved == refWorld.getComponent<PointComponent>(entities[9]));
+        [[maybe_unused]] auto* unmoved = ref.resolve(refWorld);
+        assert(unmoved == point);
+
+        // Destroyed targets, other worlds and cleared worlds resolve to nothing
+        [[maybe_unused]] const auto destroyed = refWorld.removeEntity(entities[3]);
+        [[maybe_unused]] auto* missing = ref.resolve(refWorld);
+        assert(missing == nullptr);
+        ecsWorld otherWorld;
+        [[maybe_unused]] auto* foreign = lastRef.resolve(otherWorld);
+        assert(foreign == nullptr);
+        [[maybe_unused]] auto* refound = lastRef.resolve(refWorld);
+        refWorld.clear();
+        [[maybe_unused]] auto* cleared = lastRef.resolve(refWorld);
+        assert(refound != nullptr && cleared == nullptr);
+    }
+    // Entities hold element indexes, compact by default and 64-bit if configured
+    {
+#ifdef MINIECS_64BIT_INDICES
+        static_assert(sizeof(ComponentIndex) == 8ULL);
+#else
+        static_assert(sizeof(ComponentIndex) == 4ULL);
+#endif
+        PointComponent point;
+        ComponentDataSpace memory;
+        [[maybe_unused]] const auto first = createFn<PointComponent>(memory, {}, {}, &point);
+        [[maybe_unused]] const auto second = createFn<PointComponent>(memory, {}, {}, &point);
+        assert(first == 0U && second == 1U && memory.size() == 2ULL * sizeof(PointComponent));
+
+        // Rows rebase when spliced and follow the rows moved into them
+        ecsWorld indexWorld;
+        std::vector<EntityHandle> entities;
+        for (size_t i = 0; i < 8ULL; ++i) {
+            entities.emplace_back(indexWorld.makeEntity());
+            point.x = static_cast<float>(i);
+            [[maybe_unused]] const auto pointHandle = indexWorld.makeComponent(entities.back(), &point);
+        }
+        ecsSpawnBuffer buffer;
+        for (size_t i = 8ULL; i < 16ULL; ++i) {
+            entities.emplace_back(buffer.makeEntity());
+            point.x = static_cast<float>(i);
+            [[maybe_unused]] const auto pointHandle = buffer.makeComponent(entities.back(), &point);
+            [[maybe_unused]] const auto fooHandle = buffer.makeComponent<FooComponent>(entities.back());
+        }
+        indexWorld.spliceSpawnBuffer(buffer);
+        [[maybe_unused]] const auto removedFirst = indexWorld.removeEntity(entities[0]);
+        [[maybe_unused]] const auto removedSpliced = indexWorld.removeEntity(entities[9]);
+        for (size_t i = 1; i < entities.size(); ++i) {
+            [[maybe_unused]] const auto* found = indexWorld.getComponent<PointComponent>(entities[i]);
+            assert(i == 9ULL ? found == nullptr : found != nullptr && found->x == static_cast<float>(i));
+        }
+    }
+    // Migration carries shared values, and completes observed signatures with the last type
+    {
+        ecsWorld fromWorld;
+        ecsWorld toWorld;
+        const auto observer = std::make_shared<FooBarObserver>();
+        [[maybe_unused]] const auto observed = toWorld.addObserver(observer);
+        ConfigComponent config;
+        config.gravity = -1.0;
+        const auto sharedHandle = fromWorld.makeSharedComponent(&config);
+        const auto entity = fromWorld.makeEntity();
+        [[maybe_unused]] const auto fooHandle = fromWorld.makeComponent<FooComponent>(entity);
+        [[maybe_unused]] const auto barHandle = fromWorld.makeComponent<BarComponent>(entity);
+        [[maybe_unused]] const auto tagged = fromWorld.addTag<EnemyTag>(entity);
+        [[maybe_unused]] const auto shared = fromWorld.setSharedComponent(entity, sharedHandle);
+        assert(shared);
+
+        fromWorld.migrateEntityTo(entity, toWorld);
+        toWorld.flushObservers();
+        assert(observer->m_added == 1ULL);
+        [[maybe_unused]] const auto* sharedConfig = toWorld.getSharedComponent<ConfigComponent>(entity);
+        assert(sharedConfig != nullptr && sharedConfig->gravity == -1.0);
+        assert(toWorld.hasType<EnemyTag>(entity));
+    }
+    // Spawn buffers find earlier staged entities without searching
+    {
+        ecsSpawnBuffer buffer;
+        std::vector<EntityHandle> staged;
+        for (size_t i = 0; i < 64ULL; ++i) {
+            staged.emplace_back(buffer.makeEntity());
+        }
+        for (const auto& entity : staged) {
+            [[maybe_unused]] const auto fooHandle = buffer.makeComponent<FooComponent>(entity);
+            assert(fooHandle.isValid());
+        }
+        [[maybe_unused]] const auto unknownHandle = buffer.makeComponent<FooComponent>(EntityHandle());
+        assert(!unknownHandle.isValid());
+        ecsWorld stagedWorld;
+        stagedWorld.spliceSpawnBuffer(buffer);
+        assert(stagedWorld.getComponent<FooComponent>(staged.front()) != nullptr);
+        assert(stagedWorld.getComponent<FooComponent>(staged.back()) != nullptr);
+    }
+#ifdef MINIECS_COROUTINES
+    // Async systems wait on jobs without blocking, their edits apply at the end of an update
+    {
+        ecsWorld asyncWorld;
+        ecsAsyncScheduler scheduler(asyncWorld);
+        const auto path = std::make_shared<PathSystem>();
+        std::promise<int> job;
+        path->m_job = job.get_future();
+        [[maybe_unused]] const auto added = scheduler.addSystem(path);
+        [[maybe_unused]] const auto addedTwice = scheduler.addSystem(path);
+        assert(added && !addedTwice);
+        ecsSystemList systems;
+        systems.makeSystem<DriftSystem>();
+        const auto pointEntity = asyncWorld.makeEntity();
+        [[maybe_unused]] const auto pointHandle = asyncWorld.makeComponent<PointComponent>(pointEntity);
+        const std::vector<std::pair<ComponentID, ecsSystem::RequirementsFlag>> pointIDs = {
+            { PointComponent::Runtime_ID, ecsSystem::RequirementsFlag::REQUIRED }
+        };
+        const auto countPoints = [&] { return asyncWorld.getComponents<PointComponent*>(pointIDs).size(); };
+
+        // Waiting runs aren't started again, and other systems keep updating
+        scheduler.updateSystems(systems, 1.0);
+        scheduler.updateSystems(systems, 1.0);
+        assert(path->m_starts == 1ULL && path->isRunning() && scheduler.getRunningCount() == 1ULL);
+        assert(asyncWorld.getComponent<PointComponent>(pointEntity)->x == 2.0F);
+        assert(countPoints() == 1ULL);
+
+        // The finished job resumes the run, whose edit waits for the sync point
+        job.set_value(7);
+        scheduler.updateSystems(systems, 1.0);
+        assert(countPoints() == 2ULL && path->m_finishes == 0ULL);
+        [[maybe_unused]] const auto points = asyncWorld.getComponents<PointComponent*>(pointIDs);
+        assert(std::any_of(points.cbegin(), points.cend(), [](const auto& row) {
+            return std::get<0>(row)->x == 7.0F;
+        }));
+        scheduler.updateSystems(systems, 1.0);
+        assert(path->m_finishes == 1ULL && !path->isRunning());
+
+        // The next update starts a new run, removal abandons it
+        std::promise<int> nextJob;
+        path->m_job = nextJob.get_future();
+        scheduler.updateSystems(systems, 1.0);
+        assert(path->m_starts == 2ULL && path->isRunning());
+        [[maybe_unused]] const auto removed = scheduler.removeSystem(*path);
+        assert(removed && !path->isRunning() && scheduler.getRunningCount() == 0ULL);
+    }
+#endif
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include "ecsTrace.hpp"
+#include "ecsWorld.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace mini;
+
+///////////////////////////////////////////////////////////////////////////
+/// Every allocation made by the process is counted
+static std::atomic<size_t> g_allocationCount(0ULL);
+static std::atomic<size_t> g_allocationBytes(0ULL);
+
+void* operator new(const size_t size) {
+    g_allocationCount.fetch_add(1ULL, std::memory_order_relaxed);
+    g_allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    if (auto* memory = std::malloc(size == 0ULL ? 1ULL : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, const size_t) noexcept { std::free(memory); }
+
+///////////////////////////////////////////////////////////////////////////
+/// \class  CacheMissCounter
+/// \brief  Counts hardware cache misses with perf_event, where available.
+class CacheMissCounter final {
+    public:
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Stop counting.
+    ~CacheMissCounter() {
+#if defined(__linux__)
+        if (m_descriptor >= 0) {
+            close(m_descriptor);
+        }
+#endif
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Open a counter for this process, disabled until started.
+    CacheMissCounter() {
+#if defined(__linux__)
+        perf_event_attr attributes{};
+        attributes.type = PERF_TYPE_HARDWARE;
+        attributes.size = sizeof(attributes);
+        attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+        attributes.disabled = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        m_descriptor = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+#endif
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Check if the counter could be opened.
+    /// \return	true if cache misses can be counted, false otherwise.
+    [[nodiscard]] bool isOpen() const noexcept { return m_descriptor >= 0; }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Reset and start counting.
+    void start() noexcept {
+#if defined(__linux__)
+        if (m_descriptor >= 0) {
+            ioctl(m_descriptor, PERF_EVENT_IOC_RESET, 0);
+            ioctl(m_descriptor, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Stop counting.
+    /// \return	the number of cache misses since started.
+    [[nodiscard]] uint64_t stop() noexcept {
+        uint64_t misses(0ULL);
+#if defined(__linux__)
+        if (m_descriptor >= 0) {
+            ioctl(m_descriptor, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(m_descriptor, &misses, sizeof(misses)) != static_cast<ssize_t>(sizeof(misses))) {
+                misses = 0ULL;
+            }
+        }
+#endif
+        return misses;
+    }
+
+    private:
+    int m_descriptor = -1; ///< The perf_event file descriptor.
+};
+
+///////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieve the peak resident set size of this process.
+/// \return	the peak RSS in kilobytes, zero if unknown.
+static size_t getPeakResidentKilobytes() noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(__APPLE__)
+        return static_cast<size_t>(usage.ru_maxrss) / 1024ULL;
+#else
+        return static_cast<size_t>(usage.ru_maxrss);
+#endif
+    }
+#endif
+    return 0ULL;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// \brief  Replay a trace against fresh worlds, reporting what it cost.
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <trace> [--repeat N] [--perf]\n";
+        return EXIT_FAILURE;
+    }
+
+    size_t repeats(1ULL);
+    bool countCacheMisses = false;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeats = std::max(1ULL, std::strtoull(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--perf") == 0) {
+            countCacheMisses = true;
+        }
+    }
+
+    ecsTraceReplayer replayer;
+    if (!replayer.load(std::string(argv[1]))) {
+        std::cerr << "Failed to load trace: " << argv[1] << "\n";
+        return EXIT_FAILURE;
+    }
+
+    // Only the replays are measured, loading the trace is excluded
+    CacheMissCounter counter;
+    const auto allocationCount = g_allocationCount.load();
+    const auto allocationBytes = g_allocationBytes.load();
+    if (countCacheMisses) {
+        counter.start();
+    }
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repeats; ++i) {
+        ecsWorld world;
+        if (!replayer.replay(world)) {
+            std::cerr << "Malformed trace after " << replayer.getOperationCount() << " operations\n";
+            return EXIT_FAILURE;
+        }
+    }
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    const auto cacheMisses = countCacheMisses ? counter.stop() : 0ULL;
+
+    std::cout << "operations:     " << replayer.getOperationCount() << " x " << repeats << "\n"
+              << "query rows:     " << replayer.getQueryRowCount() << "\n"
+              << "wall time:      " << elapsed << " ms\n"
+              << "allocations:    " << g_allocationCount.load() - allocationCount << " ("
+              << g_allocationBytes.load() - allocationBytes << " bytes)\n"
+              << "peak RSS:       " << getPeakResidentKilobytes() << " KB\n";
+    if (countCacheMisses) {
+        if (counter.isOpen()) {
+            std::cout << "cache misses:   " << cacheMisses << "\n";
+        } else {
+            std::cout << "cache misses:   unavailable\n";
+        }
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file